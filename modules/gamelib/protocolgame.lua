@@ -2,13 +2,11 @@ local opcodeCallbacks = {}
 local extendedCallbacks = {}
 
 function ProtocolGame:onOpcode(opcode, msg)
-    for i, callback in pairs(opcodeCallbacks) do
-        if i == opcode then
-            callback(self, msg)
-            return true
-        end
-    end
-    return false
+    local callback = opcodeCallbacks[opcode]
+    if not callback then return false end
+
+    callback(self, msg)
+    return true
 end
 
 function ProtocolGame:onExtendedOpcode(opcode, buffer)
@@ -22,9 +20,13 @@ function ProtocolGame.registerOpcode(opcode, callback)
     end
 
     opcodeCallbacks[opcode] = callback
+    ProtocolGame.setLuaOpcode(opcode, true)
 end
 
-function ProtocolGame.unregisterOpcode(opcode) opcodeCallbacks[opcode] = nil end
+function ProtocolGame.unregisterOpcode(opcode)
+    opcodeCallbacks[opcode] = nil
+    ProtocolGame.setLuaOpcode(opcode, false)
+end
 
 function ProtocolGame.registerExtendedOpcode(opcode, callback)
     if not callback or type(callback) ~= 'function' then
@@ -28,6 +28,7 @@
 #include <client/client.h>
 #include <client/map/map.h>
 #include <client/map/minimap.h>
+#include <client/thing/creature/walkticker.h>
 #include <client/manager/shadermanager.h>
 #include <client/manager/spritemanager.h>
 
@@ -85,6 +86,7 @@ void Client::terminate()
 {
     g_creatures.terminate();
     g_game.terminate();
+    g_walkTicker.terminate();
     g_map.terminate();
     g_minimap.terminate();
     g_things.terminate();
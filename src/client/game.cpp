@@ -121,7 +121,7 @@ void Game::processConnectionError(const boost::system::error_code& ec)
     if(m_protocolGame) {
         // eof = end of file, a clean disconnect
         if(ec != asio::error::eof)
-            g_lua.callGlobalField("g_game", "onConnectionError", ec.message(), ec.value());
+            g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onConnectionError"), ec.message(), ec.value());
 
         processDisconnect();
     }
@@ -140,45 +140,45 @@ void Game::processDisconnect()
 
 void Game::processUpdateNeeded(const std::string& signature)
 {
-    g_lua.callGlobalField("g_game", "onUpdateNeeded", signature);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onUpdateNeeded"), signature);
 }
 
 void Game::processLoginError(const std::string& error)
 {
-    g_lua.callGlobalField("g_game", "onLoginError", error);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onLoginError"), error);
 }
 
 void Game::processLoginAdvice(const std::string& message)
 {
-    g_lua.callGlobalField("g_game", "onLoginAdvice", message);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onLoginAdvice"), message);
 }
 
 void Game::processLoginWait(const std::string& message, uint8 time)
 {
-    g_lua.callGlobalField("g_game", "onLoginWait", message, time);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onLoginWait"), message, time);
 }
 
 void Game::processLoginToken(bool unknown)
 {
-    g_lua.callGlobalField("g_game", "onLoginToken", unknown);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onLoginToken"), unknown);
 }
 
 void Game::processLogin()
 {
-    g_lua.callGlobalField("g_game", "onLogin");
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onLogin"));
 }
 
 void Game::processPendingGame()
 {
     m_localPlayer->setPendingGame(true);
-    g_lua.callGlobalField("g_game", "onPendingGame");
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onPendingGame"));
     m_protocolGame->sendEnterGame();
 }
 
 void Game::processEnterGame()
 {
     m_localPlayer->setPendingGame(false);
-    g_lua.callGlobalField("g_game", "onEnterGame");
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onEnterGame"));
 }
 
 void Game::processGameStart()
@@ -190,7 +190,7 @@ void Game::processGameStart()
 
     // NOTE: the entire map description and local player information is not known yet (bot call is allowed here)
     enableBotCall();
-    g_lua.callGlobalField("g_game", "onGameStart");
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onGameStart"));
     disableBotCall();
 
     m_pingEvent = g_dispatcher.scheduleEvent([this] {
@@ -199,10 +199,10 @@ void Game::processGameStart()
 
     m_checkConnectionEvent = g_dispatcher.cycleEvent([this] {
         if(!g_game.isConnectionOk() && !m_connectionFailWarned) {
-            g_lua.callGlobalField("g_game", "onConnectionFailing", true);
+            g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onConnectionFailing"), true);
             m_connectionFailWarned = true;
         } else if(g_game.isConnectionOk() && m_connectionFailWarned) {
-            g_lua.callGlobalField("g_game", "onConnectionFailing", false);
+            g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onConnectionFailing"), false);
             m_connectionFailWarned = false;
         }
     }, 1000);
@@ -211,10 +211,10 @@ void Game::processGameStart()
 void Game::processGameEnd()
 {
     m_online = false;
-    g_lua.callGlobalField("g_game", "onGameEnd");
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onGameEnd"));
 
     if(m_connectionFailWarned) {
-        g_lua.callGlobalField("g_game", "onConnectionFailing", false);
+        g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onConnectionFailing"), false);
         m_connectionFailWarned = false;
     }
 
@@ -233,13 +233,13 @@ void Game::processDeath(uint8 deathType, uint8 penality, bool deathRedemption)
     m_dead = true;
     m_localPlayer->stopWalk();
 
-    g_lua.callGlobalField("g_game", "onDeath", deathType, penality, deathRedemption);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onDeath"), deathType, penality, deathRedemption);
 }
 
 void Game::processGMActions(const std::vector<uint8>& actions)
 {
     m_gmActions = actions;
-    g_lua.callGlobalField("g_game", "onGMActions", actions);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onGMActions"), actions);
 }
 
 void Game::processPlayerModes(Otc::FightModes_t fightMode, Otc::ChaseModes_t chaseMode, bool safeMode, Otc::PVPModes_t pvpMode)
@@ -249,15 +249,15 @@ void Game::processPlayerModes(Otc::FightModes_t fightMode, Otc::ChaseModes_t cha
     m_safeFight = safeMode;
     m_pvpMode = pvpMode;
 
-    g_lua.callGlobalField("g_game", "onFightModeChange", fightMode);
-    g_lua.callGlobalField("g_game", "onChaseModeChange", chaseMode);
-    g_lua.callGlobalField("g_game", "onSafeFightChange", safeMode);
-    g_lua.callGlobalField("g_game", "onPVPModeChange", pvpMode);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onFightModeChange"), fightMode);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onChaseModeChange"), chaseMode);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onSafeFightChange"), safeMode);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onPVPModeChange"), pvpMode);
 }
 
 void Game::processPing()
 {
-    g_lua.callGlobalField("g_game", "onPing");
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onPing"));
     enableBotCall();
     m_protocolGame->sendPingBack();
     disableBotCall();
@@ -272,7 +272,7 @@ void Game::processPingBack()
     else
         g_logger.error("got an invalid ping from server");
 
-    g_lua.callGlobalField("g_game", "onPingBack", m_ping);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onPingBack"), m_ping);
 
     m_pingEvent = g_dispatcher.scheduleEvent([this] {
         g_game.ping();
@@ -281,12 +281,12 @@ void Game::processPingBack()
 
 void Game::processTextMessage(Otc::MessageMode_t mode, const std::string& text)
 {
-    g_lua.callGlobalField("g_game", "onTextMessage", mode, text);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onTextMessage"), mode, text);
 }
 
 void Game::processTalk(const std::string& name, int level, Otc::MessageMode_t mode, const std::string& text, int channelId, const Position& pos)
 {
-    g_lua.callGlobalField("g_game", "onTalk", name, level, mode, text, channelId, pos);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onTalk"), name, level, mode, text, channelId, pos);
 }
 
 void Game::processOpenContainer(int containerId, const ItemPtr& containerItem, const std::string& name, int capacity, bool hasParent, const std::vector<ItemPtr>& items, bool isUnlocked, bool hasPages, int containerSize, int firstIndex)
@@ -356,74 +356,74 @@ void Game::processInventoryChange(int slot, const ItemPtr& item)
 
 void Game::processChannelList(const std::vector<std::tuple<uint8, std::string> >& channelList)
 {
-    g_lua.callGlobalField("g_game", "onChannelList", channelList);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onChannelList"), channelList);
 }
 
 void Game::processOpenChannel(int channelId, const std::string& name)
 {
-    g_lua.callGlobalField("g_game", "onOpenChannel", channelId, name);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onOpenChannel"), channelId, name);
 }
 
 void Game::processOpenPrivateChannel(const std::string& name)
 {
-    g_lua.callGlobalField("g_game", "onOpenPrivateChannel", name);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onOpenPrivateChannel"), name);
 }
 
 void Game::processOpenOwnPrivateChannel(int channelId, const std::string& name)
 {
-    g_lua.callGlobalField("g_game", "onOpenOwnPrivateChannel", channelId, name);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onOpenOwnPrivateChannel"), channelId, name);
 }
 
 void Game::processCloseChannel(int channelId)
 {
-    g_lua.callGlobalField("g_game", "onCloseChannel", channelId);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onCloseChannel"), channelId);
 }
 
 void Game::processRuleViolationChannel(int channelId)
 {
-    g_lua.callGlobalField("g_game", "onRuleViolationChannel", channelId);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onRuleViolationChannel"), channelId);
 }
 
 void Game::processRuleViolationRemove(const std::string& name)
 {
-    g_lua.callGlobalField("g_game", "onRuleViolationRemove", name);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onRuleViolationRemove"), name);
 }
 
 void Game::processRuleViolationCancel(const std::string& name)
 {
-    g_lua.callGlobalField("g_game", "onRuleViolationCancel", name);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onRuleViolationCancel"), name);
 }
 
 void Game::processRuleViolationLock()
 {
-    g_lua.callGlobalField("g_game", "onRuleViolationLock");
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onRuleViolationLock"));
 }
 
 void Game::processVipAdd(uint id, const std::string& name, uint status, const std::string& description, int iconId, bool notifyLogin)
 {
     m_vips[id] = Vip(name, status, description, iconId, notifyLogin);
-    g_lua.callGlobalField("g_game", "onAddVip", id, name, status, description, iconId, notifyLogin);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onAddVip"), id, name, status, description, iconId, notifyLogin);
 }
 
 void Game::processVipStateChange(uint id, uint status)
 {
     std::get<1>(m_vips[id]) = status;
-    g_lua.callGlobalField("g_game", "onVipStateChange", id, status);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onVipStateChange"), id, status);
 }
 
 void Game::processTutorialHint(int id)
 {
-    g_lua.callGlobalField("g_game", "onTutorialHint", id);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onTutorialHint"), id);
 }
 
 void Game::processAddAutomapFlag(const Position& pos, int icon, const std::string& message)
 {
-    g_lua.callGlobalField("g_game", "onAddAutomapFlag", pos, icon, message);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onAddAutomapFlag"), pos, icon, message);
 }
 
 void Game::processRemoveAutomapFlag(const Position& pos, int icon, const std::string& message)
 {
-    g_lua.callGlobalField("g_game", "onRemoveAutomapFlag", pos, icon, message);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onRemoveAutomapFlag"), pos, icon, message);
 }
 
 void Game::processOpenOutfitWindow(const Outfit& currentOutfit, const std::vector<std::tuple<uint16, std::string, uint8>>& outfitList,
@@ -454,64 +454,64 @@ void Game::processOpenOutfitWindow(const Outfit& currentOutfit, const std::vecto
     virtualFamiliarCreature->setDirection(Otc::South);
     virtualFamiliarCreature->setOutfit(familiarOutfit);
 
-    g_lua.callGlobalField("g_game", "onOpenOutfitWindow", virtualOutfitCreature, outfitList, virtualMountCreature, mountList, virtualFamiliarCreature, familiarList);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onOpenOutfitWindow"), virtualOutfitCreature, outfitList, virtualMountCreature, mountList, virtualFamiliarCreature, familiarList);
 }
 
 void Game::processOpenNpcTrade(const std::vector<std::tuple<ItemPtr, std::string, int, int, int> >& items)
 {
-    g_lua.callGlobalField("g_game", "onOpenNpcTrade", items);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onOpenNpcTrade"), items);
 }
 
 void Game::processPlayerGoods(uint64 money, const std::vector<std::tuple<ItemPtr, uint16> >& goods)
 {
-    g_lua.callGlobalField("g_game", "onPlayerGoods", money, goods);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onPlayerGoods"), money, goods);
 }
 
 void Game::processCloseNpcTrade()
 {
-    g_lua.callGlobalField("g_game", "onCloseNpcTrade");
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onCloseNpcTrade"));
 }
 
 void Game::processOwnTrade(const std::string& name, const std::vector<ItemPtr>& items)
 {
-    g_lua.callGlobalField("g_game", "onOwnTrade", name, items);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onOwnTrade"), name, items);
 }
 
 void Game::processCounterTrade(const std::string& name, const std::vector<ItemPtr>& items)
 {
-    g_lua.callGlobalField("g_game", "onCounterTrade", name, items);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onCounterTrade"), name, items);
 }
 
 void Game::processCloseTrade()
 {
-    g_lua.callGlobalField("g_game", "onCloseTrade");
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onCloseTrade"));
 }
 
 void Game::processEditText(uint id, int itemId, int maxLength, const std::string& text, const std::string& writer, const std::string& date)
 {
-    g_lua.callGlobalField("g_game", "onEditText", id, itemId, maxLength, text, writer, date);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onEditText"), id, itemId, maxLength, text, writer, date);
 }
 
 void Game::processEditList(uint id, int doorId, const std::string& text)
 {
-    g_lua.callGlobalField("g_game", "onEditList", id, doorId, text);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onEditList"), id, doorId, text);
 }
 
 void Game::processQuestLog(const std::vector<std::tuple<uint16, std::string, bool> >& questList)
 {
-    g_lua.callGlobalField("g_game", "onQuestLog", questList);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onQuestLog"), questList);
 }
 
 void Game::processQuestLine(int questId, const std::vector<std::tuple<std::string, std::string> >& questMissions)
 {
-    g_lua.callGlobalField("g_game", "onQuestLine", questId, questMissions);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onQuestLine"), questId, questMissions);
 }
 
 void Game::processModalDialog(uint32 id, const std::string& title, const std::string& message, const std::vector<std::tuple<int, std::string> >
                               & buttonList, int enterButton, int escapeButton, const std::vector<std::tuple<int, std::string> >
                               & choiceList, bool priority)
 {
-    g_lua.callGlobalField("g_game", "onModalDialog", id, title, message, buttonList, enterButton, escapeButton, choiceList, priority);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onModalDialog"), id, title, message, buttonList, enterButton, escapeButton, choiceList, priority);
 }
 
 void Game::processAttackCancel(uint seq)
@@ -648,7 +648,7 @@ bool Game::walk(const Otc::Direction_t direction)
 
     m_localPlayer->stopAutoWalk();
 
-    g_lua.callGlobalField("g_game", "onWalk", direction);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onWalk"), direction);
 
     forceWalk(direction);
 
@@ -687,7 +687,7 @@ void Game::autoWalk(std::vector<Otc::Direction_t> dirs)
         dirs.erase(it);
     }
 
-    g_lua.callGlobalField("g_game", "onAutoWalk", dirs);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onAutoWalk"), dirs);
 
     m_protocolGame->sendAutoWalk(dirs);
 }
@@ -726,7 +726,7 @@ void Game::forceWalk(Otc::Direction_t direction)
         break;
     }
 
-    g_lua.callGlobalField("g_game", "onForceWalk", direction);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onForceWalk"), direction);
 }
 
 void Game::turn(Otc::Direction_t direction)
@@ -964,7 +964,7 @@ void Game::cancelAttackAndFollow()
 
     m_protocolGame->sendCancelAttackAndFollow();
 
-    g_lua.callGlobalField("g_game", "onCancelAttackAndFollow");
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onCancelAttackAndFollow"));
 }
 
 void Game::talk(const std::string& message)
@@ -1144,7 +1144,7 @@ void Game::setChaseMode(Otc::ChaseModes_t chaseMode)
         return;
     m_chaseMode = chaseMode;
     m_protocolGame->sendChangeFightModes(m_fightMode, m_chaseMode, m_safeFight, m_pvpMode);
-    g_lua.callGlobalField("g_game", "onChaseModeChange", chaseMode);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onChaseModeChange"), chaseMode);
 }
 
 void Game::setFightMode(Otc::FightModes_t fightMode)
@@ -1155,7 +1155,7 @@ void Game::setFightMode(Otc::FightModes_t fightMode)
         return;
     m_fightMode = fightMode;
     m_protocolGame->sendChangeFightModes(m_fightMode, m_chaseMode, m_safeFight, m_pvpMode);
-    g_lua.callGlobalField("g_game", "onFightModeChange", fightMode);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onFightModeChange"), fightMode);
 }
 
 void Game::setSafeFight(bool on)
@@ -1166,7 +1166,7 @@ void Game::setSafeFight(bool on)
         return;
     m_safeFight = on;
     m_protocolGame->sendChangeFightModes(m_fightMode, m_chaseMode, m_safeFight, m_pvpMode);
-    g_lua.callGlobalField("g_game", "onSafeFightChange", on);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onSafeFightChange"), on);
 }
 
 void Game::setPVPMode(Otc::PVPModes_t pvpMode)
@@ -1179,7 +1179,7 @@ void Game::setPVPMode(Otc::PVPModes_t pvpMode)
 
     m_pvpMode = pvpMode;
     m_protocolGame->sendChangeFightModes(m_fightMode, m_chaseMode, m_safeFight, m_pvpMode);
-    g_lua.callGlobalField("g_game", "onPVPModeChange", pvpMode);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onPVPModeChange"), pvpMode);
 }
 
 void Game::setUnjustifiedPoints(UnjustifiedPoints unjustifiedPoints)
@@ -1191,7 +1191,7 @@ void Game::setUnjustifiedPoints(UnjustifiedPoints unjustifiedPoints)
         return;
 
     m_unjustifiedPoints = unjustifiedPoints;
-    g_lua.callGlobalField("g_game", "onUnjustifiedPointsChange", unjustifiedPoints);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onUnjustifiedPointsChange"), unjustifiedPoints);
 }
 
 void Game::setOpenPvpSituations(int openPvpSituations)
@@ -1202,7 +1202,7 @@ void Game::setOpenPvpSituations(int openPvpSituations)
         return;
 
     m_openPvpSituations = openPvpSituations;
-    g_lua.callGlobalField("g_game", "onOpenPvpSituationsChange", openPvpSituations);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onOpenPvpSituationsChange"), openPvpSituations);
 }
 
 void Game::inspectNpcTrade(const ItemPtr& item)
@@ -1474,7 +1474,7 @@ void Game::setProtocolVersion(int version)
 
     m_protocolVersion = version;
 
-    g_lua.callGlobalField("g_game", "onProtocolVersionChange", version);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onProtocolVersionChange"), version);
 }
 
 void Game::setClientVersion(int version)
@@ -1494,7 +1494,7 @@ void Game::setClientVersion(int version)
 
     m_clientVersion = version;
 
-    g_lua.callGlobalField("g_game", "onClientVersionChange", version);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onClientVersionChange"), version);
 }
 
 void Game::setAttackingCreature(const CreaturePtr& creature)
@@ -1503,7 +1503,7 @@ void Game::setAttackingCreature(const CreaturePtr& creature)
         const CreaturePtr oldCreature = m_attackingCreature;
         m_attackingCreature = creature;
 
-        g_lua.callGlobalField("g_game", "onAttackingCreatureChange", creature, oldCreature);
+        g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onAttackingCreatureChange"), creature, oldCreature);
     }
 }
 
@@ -1512,7 +1512,7 @@ void Game::setFollowingCreature(const CreaturePtr& creature)
     const CreaturePtr oldCreature = m_followingCreature;
     m_followingCreature = creature;
 
-    g_lua.callGlobalField("g_game", "onFollowingCreatureChange", creature, oldCreature);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onFollowingCreatureChange"), creature, oldCreature);
 }
 
 std::string Game::formatCreatureName(const std::string& name)
@@ -101,6 +101,8 @@ void Client::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_sprites", "isLoaded", &SpriteManager::isLoaded, &g_sprites);
     g_lua.bindSingletonFunction("g_sprites", "getSprSignature", &SpriteManager::getSignature, &g_sprites);
     g_lua.bindSingletonFunction("g_sprites", "getSpritesCount", &SpriteManager::getSpritesCount, &g_sprites);
+    g_lua.bindSingletonFunction("g_sprites", "getAtlasPageCount", &SpriteManager::getAtlasPageCount, &g_sprites);
+    g_lua.bindSingletonFunction("g_sprites", "getAtlasEvictions", &SpriteManager::getAtlasEvictions, &g_sprites);
 
     g_lua.registerSingletonClass("g_map");
     g_lua.bindSingletonFunction("g_map", "isLookPossible", &Map::isLookPossible, &g_map);
@@ -123,7 +125,10 @@ void Client::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_map", "removeCreatureById", &Map::removeCreatureById, &g_map);
     g_lua.bindSingletonFunction("g_map", "getSpectators", &Map::getSpectators, &g_map);
     g_lua.bindSingletonFunction("g_map", "findPath", &Map::findPath, &g_map);
+    g_lua.bindSingletonFunction("g_map", "findPathAsync", &Map::findPathAsync, &g_map);
+    g_lua.bindSingletonFunction("g_map", "cancelPathFind", &Map::cancelPathFind, &g_map);
     g_lua.bindSingletonFunction("g_map", "loadOtbm", &Map::loadOtbm, &g_map);
+    g_lua.bindSingletonFunction("g_map", "cancelOtbmLoad", &Map::cancelOtbmLoad, &g_map);
     g_lua.bindSingletonFunction("g_map", "saveOtbm", &Map::saveOtbm, &g_map);
     g_lua.bindSingletonFunction("g_map", "loadOtcm", &Map::loadOtcm, &g_map);
     g_lua.bindSingletonFunction("g_map", "saveOtcm", &Map::saveOtcm, &g_map);
@@ -162,6 +167,7 @@ void Client::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_minimap", "saveImage", &Minimap::saveImage, &g_minimap);
     g_lua.bindSingletonFunction("g_minimap", "loadOtmm", &Minimap::loadOtmm, &g_minimap);
     g_lua.bindSingletonFunction("g_minimap", "saveOtmm", &Minimap::saveOtmm, &g_minimap);
+    g_lua.bindSingletonFunction("g_minimap", "getMemoryUsage", &Minimap::getMemoryUsage, &g_minimap);
 
     g_lua.registerSingletonClass("g_creatures");
     g_lua.bindSingletonFunction("g_creatures", "getCreatures", &CreatureManager::getCreatures, &g_creatures);
@@ -327,6 +333,13 @@ void Client::registerLuaFunctions()
     g_lua.bindClassStaticFunction<ProtocolGame>("create", [] { return ProtocolGamePtr(new ProtocolGame); });
     g_lua.bindClassMemberFunction<ProtocolGame>("login", &ProtocolGame::login);
     g_lua.bindClassMemberFunction<ProtocolGame>("sendExtendedOpcode", &ProtocolGame::sendExtendedOpcode);
+    g_lua.bindClassStaticFunction<ProtocolGame>("setLuaOpcode", &ProtocolGame::setLuaOpcode);
+    g_lua.bindClassStaticFunction<ProtocolGame>("isLuaOpcode", &ProtocolGame::isLuaOpcode);
+    g_lua.bindClassStaticFunction<ProtocolGame>("setOpcodeStatsEnabled", &ProtocolGame::setOpcodeStatsEnabled);
+    g_lua.bindClassStaticFunction<ProtocolGame>("isOpcodeStatsEnabled", &ProtocolGame::isOpcodeStatsEnabled);
+    g_lua.bindClassStaticFunction<ProtocolGame>("getOpcodeCount", &ProtocolGame::getOpcodeCount);
+    g_lua.bindClassStaticFunction<ProtocolGame>("getOpcodeParseTime", &ProtocolGame::getOpcodeParseTime);
+    g_lua.bindClassStaticFunction<ProtocolGame>("resetOpcodeStats", &ProtocolGame::resetOpcodeStats);
     g_lua.bindClassMemberFunction<ProtocolGame>("addPosition", &ProtocolGame::addPosition);
     g_lua.bindClassMemberFunction<ProtocolGame>("setMapDescription", &ProtocolGame::setMapDescription);
     g_lua.bindClassMemberFunction<ProtocolGame>("setFloorDescription", &ProtocolGame::setFloorDescription);
@@ -560,6 +573,9 @@ void Client::registerLuaFunctions()
     g_lua.registerClass<Item, Thing>();
     g_lua.bindClassStaticFunction<Item>("create", &Item::create);
     g_lua.bindClassStaticFunction<Item>("createOtb", &Item::createFromOtb);
+    g_lua.bindClassStaticFunction<Item>("getPoolCapacity", &ObjectPool<Item>::getCapacity);
+    g_lua.bindClassStaticFunction<Item>("getPoolUsage", &ObjectPool<Item>::getUsage);
+    g_lua.bindClassStaticFunction<Item>("getPoolHitRate", &ObjectPool<Item>::getHitRate);
     g_lua.bindClassMemberFunction<Item>("clone", &Item::clone);
     g_lua.bindClassMemberFunction<Item>("getContainerItems", &Item::getContainerItems);
     g_lua.bindClassMemberFunction<Item>("getContainerItem", &Item::getContainerItem);
@@ -592,10 +608,16 @@ void Client::registerLuaFunctions()
 
     g_lua.registerClass<Effect, Thing>();
     g_lua.bindClassStaticFunction<Effect>("create", [] { return EffectPtr(new Effect); });
+    g_lua.bindClassStaticFunction<Effect>("getPoolCapacity", &ObjectPool<Effect>::getCapacity);
+    g_lua.bindClassStaticFunction<Effect>("getPoolUsage", &ObjectPool<Effect>::getUsage);
+    g_lua.bindClassStaticFunction<Effect>("getPoolHitRate", &ObjectPool<Effect>::getHitRate);
     g_lua.bindClassMemberFunction<Effect>("setId", &Effect::setId);
 
     g_lua.registerClass<Missile, Thing>();
     g_lua.bindClassStaticFunction<Missile>("create", [] { return MissilePtr(new Missile); });
+    g_lua.bindClassStaticFunction<Missile>("getPoolCapacity", &ObjectPool<Missile>::getCapacity);
+    g_lua.bindClassStaticFunction<Missile>("getPoolUsage", &ObjectPool<Missile>::getUsage);
+    g_lua.bindClassStaticFunction<Missile>("getPoolHitRate", &ObjectPool<Missile>::getHitRate);
     g_lua.bindClassMemberFunction<Missile>("setId", &Missile::setId);
     g_lua.bindClassMemberFunction<Missile>("setPath", &Missile::setPath);
 
@@ -608,6 +630,9 @@ void Client::registerLuaFunctions()
     g_lua.bindClassMemberFunction<StaticText>("getColor", &StaticText::getColor);
 
     g_lua.registerClass<AnimatedText, Thing>();
+    g_lua.bindClassStaticFunction<AnimatedText>("getPoolCapacity", &ObjectPool<AnimatedText>::getCapacity);
+    g_lua.bindClassStaticFunction<AnimatedText>("getPoolUsage", &ObjectPool<AnimatedText>::getUsage);
+    g_lua.bindClassStaticFunction<AnimatedText>("getPoolHitRate", &ObjectPool<AnimatedText>::getHitRate);
 
     g_lua.registerClass<Player, Creature>();
     g_lua.registerClass<Npc, Creature>();
@@ -25,6 +25,7 @@
 #include <client/map/tile.h>
 
 #include <framework/core/application.h>
+#include <framework/core/asyncdispatcher.h>
 #include <framework/core/binarytree.h>
 #include <framework/core/eventdispatcher.h>
 #include <framework/core/filestream.h>
@@ -32,7 +33,148 @@
 #include <framework/ui/uiwidget.h>
 #include <framework/xml/tinyxml.h>
 
-void Map::loadOtbm(const std::string& fileName)
+namespace
+{
+    struct OtbmTile
+    {
+        Position pos;
+        uint32 flags{ TILESTATE_NONE };
+        uint32 houseId{ 0 };
+        std::vector<ItemPtr> items;
+    };
+
+    // a tile area parsed apart from the map, messages are logged by the main thread when merging it
+    struct OtbmArea
+    {
+        std::vector<OtbmTile> tiles;
+        std::vector<std::string> errors;
+        std::vector<std::string> warnings;
+        std::string exception;
+    };
+
+    // Item::createFromOtb logs invalid ids and worker threads must not log, so they are reported with the area
+    ItemPtr createOtbmItem(uint16 id, OtbmArea& area)
+    {
+        if(!g_things.isValidOtbId(id) || g_things.rawGetItemType(id)->isNull()) {
+            area.errors.push_back(stdext::format("invalid thing type, server id: %d", id));
+            return nullptr;
+        }
+
+        return Item::createFromOtb(id);
+    }
+
+    OtbmArea parseOtbmArea(const std::string& fileName, const std::string& data, const std::atomic<bool>& canceled)
+    {
+        OtbmArea area;
+        try {
+            const FileStreamPtr fin(new FileStream(fileName, data));
+            const BinaryTreePtr nodeMapData = fin->getBinaryTree();
+            if(nodeMapData->getU8() != OTBM_TILE_AREA)
+                stdext::throw_exception("invalid tile area node");
+
+            Position basePos;
+            basePos.x = nodeMapData->getU16();
+            basePos.y = nodeMapData->getU16();
+            basePos.z = nodeMapData->getU8();
+
+            for(const BinaryTreePtr& nodeTile : nodeMapData->getChildren()) {
+                if(canceled)
+                    break;
+
+                const uint8 type = nodeTile->getU8();
+                if(unlikely(type != OTBM_TILE && type != OTBM_HOUSETILE))
+                    stdext::throw_exception(stdext::format("invalid node tile type %d", static_cast<int>(type)));
+
+                area.tiles.emplace_back();
+                OtbmTile& tile = area.tiles.back();
+                tile.pos = basePos + nodeTile->getPoint();
+
+                if(type == OTBM_HOUSETILE)
+                    tile.houseId = nodeTile->getU32();
+
+                while(nodeTile->canRead()) {
+                    const uint8 tileAttr = nodeTile->getU8();
+                    switch(tileAttr) {
+                    case OTBM_ATTR_TILE_FLAGS:
+                    {
+                        const uint32 _flags = nodeTile->getU32();
+                        if((_flags & TILESTATE_PROTECTIONZONE) == TILESTATE_PROTECTIONZONE)
+                            tile.flags |= TILESTATE_PROTECTIONZONE;
+                        else if((_flags & TILESTATE_OPTIONALZONE) == TILESTATE_OPTIONALZONE)
+                            tile.flags |= TILESTATE_OPTIONALZONE;
+                        else if((_flags & TILESTATE_HARDCOREZONE) == TILESTATE_HARDCOREZONE)
+                            tile.flags |= TILESTATE_HARDCOREZONE;
+
+                        if((_flags & TILESTATE_NOLOGOUT) == TILESTATE_NOLOGOUT)
+                            tile.flags |= TILESTATE_NOLOGOUT;
+
+                        if((_flags & TILESTATE_REFRESH) == TILESTATE_REFRESH)
+                            tile.flags |= TILESTATE_REFRESH;
+                        break;
+                    }
+                    case OTBM_ATTR_ITEM:
+                    {
+                        if(const ItemPtr item = createOtbmItem(nodeTile->getU16(), area))
+                            tile.items.push_back(item);
+                        break;
+                    }
+                    default:
+                    {
+                        stdext::throw_exception(stdext::format("invalid tile attribute %d at pos %s",
+                                                               static_cast<int>(tileAttr), stdext::to_string(tile.pos)));
+                    }
+                    }
+                }
+
+                for(const BinaryTreePtr& nodeItem : nodeTile->getChildren()) {
+                    if(unlikely(nodeItem->getU8() != OTBM_ITEM))
+                        stdext::throw_exception("invalid item node");
+
+                    ItemPtr item = createOtbmItem(nodeItem->getU16(), area);
+                    if(!item)
+                        continue;
+
+                    try {
+                        item->unserializeItem(nodeItem);
+                    } catch(stdext::exception& e) {
+                        area.errors.push_back(stdext::format("Failed to unserialize OTBM item: %s", e.what()));
+                    }
+
+                    if(item->isContainer()) {
+                        for(const BinaryTreePtr& containerItem : nodeItem->getChildren()) {
+                            if(containerItem->getU8() != OTBM_ITEM)
+                                stdext::throw_exception("invalid container item node");
+
+                            ItemPtr cItem = createOtbmItem(containerItem->getU16(), area);
+                            if(!cItem)
+                                continue;
+
+                            try {
+                                cItem->unserializeItem(containerItem);
+                            } catch(stdext::exception& e) {
+                                area.errors.push_back(stdext::format("Failed to unserialize OTBM item: %s", e.what()));
+                            }
+                            item->addContainerItem(cItem);
+                        }
+                    }
+
+                    if(tile.houseId != 0 && item->isMoveable()) {
+                        area.warnings.push_back(stdext::format("Moveable item found in house: %d at pos %s - escaping...", item->getId(), stdext::to_string(tile.pos)));
+                        continue;
+                    }
+
+                    tile.items.push_back(item);
+                }
+            }
+        } catch(std::exception& e) {
+            area.exception = e.what();
+        }
+
+        return area;
+    }
+}
+
+void Map::loadOtbm(const std::string& fileName, const std::function<void(float)>& onProgress)
 {
     try {
         if(!g_things.isOtbLoaded())
@@ -97,98 +239,59 @@ void Map::loadOtbm(const std::string& fileName)
             }
         }
 
-        for(const BinaryTreePtr& nodeMapData : node->getChildren()) {
-            const uint8 mapDataType = nodeMapData->getU8();
-            if(mapDataType == OTBM_TILE_AREA) {
-                Position basePos;
-                basePos.x = nodeMapData->getU16();
-                basePos.y = nodeMapData->getU16();
-                basePos.z = nodeMapData->getU8();
-
-                for(const BinaryTreePtr& nodeTile : nodeMapData->getChildren()) {
-                    const uint8 type = nodeTile->getU8();
-                    if(unlikely(type != OTBM_TILE && type != OTBM_HOUSETILE))
-                        stdext::throw_exception(stdext::format("invalid node tile type %d", static_cast<int>(type)));
-
-                    HousePtr house = nullptr;
-                    uint32 flags = TILESTATE_NONE;
-                    Position pos = basePos + nodeTile->getPoint();
-
-                    if(type == OTBM_HOUSETILE) {
-                        const uint32 hId = nodeTile->getU32();
-                        TilePtr tile = getOrCreateTile(pos);
-                        if(!(house = g_houses.getHouse(hId))) {
-                            house = HousePtr(new House(hId));
-                            g_houses.addHouse(house);
-                        }
-                        house->setTile(tile);
+        // tile areas are parsed by the async dispatcher and merged here in file order as they finish,
+        // only a few areas are kept in flight so the raw data and parsed items don't pile up
+        const auto canceled = m_otbmLoadCanceled = std::make_shared<std::atomic<bool>>(false);
+        const size_t maxAreasInFlight = (g_asyncDispatcher.getThreadCount() + 1) * 2;
+        std::deque<boost::shared_future<OtbmArea>> areas;
+
+        const auto mergeArea = [&] {
+            const boost::shared_future<OtbmArea> future = areas.front();
+            areas.pop_front();
+
+            const OtbmArea& area = future.get();
+
+            for(const std::string& error : area.errors)
+                g_logger.error(error);
+            for(const std::string& warning : area.warnings)
+                g_logger.warning(warning);
+            if(!area.exception.empty())
+                stdext::throw_exception(area.exception);
+
+            for(const OtbmTile& otbmTile : area.tiles) {
+                if(otbmTile.houseId != 0) {
+                    HousePtr house = g_houses.getHouse(otbmTile.houseId);
+                    if(!house) {
+                        house = HousePtr(new House(otbmTile.houseId));
+                        g_houses.addHouse(house);
                     }
+                    house->setTile(getOrCreateTile(otbmTile.pos));
+                }
 
-                    while(nodeTile->canRead()) {
-                        const uint8 tileAttr = nodeTile->getU8();
-                        switch(tileAttr) {
-                        case OTBM_ATTR_TILE_FLAGS:
-                        {
-                            const uint32 _flags = nodeTile->getU32();
-                            if((_flags & TILESTATE_PROTECTIONZONE) == TILESTATE_PROTECTIONZONE)
-                                flags |= TILESTATE_PROTECTIONZONE;
-                            else if((_flags & TILESTATE_OPTIONALZONE) == TILESTATE_OPTIONALZONE)
-                                flags |= TILESTATE_OPTIONALZONE;
-                            else if((_flags & TILESTATE_HARDCOREZONE) == TILESTATE_HARDCOREZONE)
-                                flags |= TILESTATE_HARDCOREZONE;
-
-                            if((_flags & TILESTATE_NOLOGOUT) == TILESTATE_NOLOGOUT)
-                                flags |= TILESTATE_NOLOGOUT;
-
-                            if((_flags & TILESTATE_REFRESH) == TILESTATE_REFRESH)
-                                flags |= TILESTATE_REFRESH;
-                            break;
-                        }
-                        case OTBM_ATTR_ITEM:
-                        {
-                            addThing(Item::createFromOtb(nodeTile->getU16()), pos);
-                            break;
-                        }
-                        default:
-                        {
-                            stdext::throw_exception(stdext::format("invalid tile attribute %d at pos %s",
-                                                                   static_cast<int>(tileAttr), stdext::to_string(pos)));
-                        }
-                        }
-                    }
-
-                    for(const BinaryTreePtr& nodeItem : nodeTile->getChildren()) {
-                        if(unlikely(nodeItem->getU8() != OTBM_ITEM))
-                            stdext::throw_exception("invalid item node");
-
-                        ItemPtr item = Item::createFromOtb(nodeItem->getU16());
-                        item->unserializeItem(nodeItem);
-
-                        if(item->isContainer()) {
-                            for(const BinaryTreePtr& containerItem : nodeItem->getChildren()) {
-                                if(containerItem->getU8() != OTBM_ITEM)
-                                    stdext::throw_exception("invalid container item node");
+                for(const ItemPtr& item : otbmTile.items)
+                    addThing(item, otbmTile.pos);
 
-                                ItemPtr cItem = Item::createFromOtb(containerItem->getU16());
-                                cItem->unserializeItem(containerItem);
-                                item->addContainerItem(cItem);
-                            }
-                        }
+                if(const TilePtr& tile = getTile(otbmTile.pos)) {
+                    if(otbmTile.houseId != 0)
+                        tile->setFlag(TILESTATE_HOUSE);
+                    tile->setFlag(otbmTile.flags);
+                }
+            }
+        };
 
-                        if(house && item->isMoveable()) {
-                            g_logger.warning(stdext::format("Moveable item found in house: %d at pos %s - escaping...", item->getId(), stdext::to_string(pos)));
-                            item.reset();
-                        }
+        const BinaryTreeVec mapDataNodes = node->getChildren();
+        for(size_t i = 0; i < mapDataNodes.size() && !*canceled; ++i) {
+            const BinaryTreePtr& nodeMapData = mapDataNodes[i];
+            const uint8 mapDataType = nodeMapData->getU8();
+            if(mapDataType == OTBM_TILE_AREA) {
+                const auto data = std::make_shared<const std::string>(nodeMapData->getRawData());
+                areas.push_back(g_asyncDispatcher.schedule([fileName, data, canceled] { return parseOtbmArea(fileName, *data, *canceled); }));
 
-                        addThing(item, pos);
-                    }
+                while(areas.size() >= maxAreasInFlight || (!areas.empty() && areas.front().is_ready()))
+                    mergeArea();
 
-                    if(const TilePtr& tile = getTile(pos)) {
-                        if(house)
-                            tile->setFlag(TILESTATE_HOUSE);
-                        tile->setFlag(flags);
-                    }
-                }
+                if(onProgress)
+                    onProgress(static_cast<float>(i + 1) / mapDataNodes.size());
             } else if(mapDataType == OTBM_TOWNS) {
                 TownPtr town = nullptr;
                 for(const BinaryTreePtr& nodeTown : nodeMapData->getChildren()) {
@@ -226,8 +329,25 @@ void Map::loadOtbm(const std::string& fileName)
                 stdext::throw_exception(stdext::format("Unknown map data node %d", static_cast<int>(mapDataType)));
         }
 
+        while(!areas.empty() && !*canceled)
+            mergeArea();
+
+        // areas still in flight stop at their next tile
+        for(const auto& area : areas)
+            area.wait();
+
+        if(*canceled)
+            g_logger.info(stdext::format("Loading of map '%s' was canceled", fileName));
+        else if(onProgress)
+            onProgress(1.f);
+
+        m_otbmLoadCanceled = nullptr;
         fin->close();
     } catch(std::exception& e) {
+        if(m_otbmLoadCanceled) {
+            *m_otbmLoadCanceled = true;
+            m_otbmLoadCanceled = nullptr;
+        }
         g_logger.error(stdext::format("Failed to load '%s': %s", fileName, e.what()));
     }
 }
@@ -298,8 +418,7 @@ void Map::saveOtbm(const std::string& fileName)
                 bool firstNode = true;
 
                 for(uint8_t z = 0; z <= MAX_Z; ++z) {
-                    for(const auto& it : m_tileBlocks[z]) {
-                        const TileBlock& block = it.second;
+                    m_tileBlocks[z].forEachBlock([&](const TileBlock& block) {
                         for(const TilePtr& tile : block.getTiles()) {
                             if(unlikely(!tile || tile->isEmpty()))
                                 continue;
@@ -351,7 +470,7 @@ void Map::saveOtbm(const std::string& fileName)
 
                             root->endNode(); // OTBM_TILE
                         }
-                    }
+                    });
                 }
 
                 if(!firstNode)
@@ -502,8 +621,7 @@ void Map::saveOtcm(const std::string& fileName)
         fin->seek(start);
 
         for(uint8_t z = 0; z <= MAX_Z; ++z) {
-            for(const auto& it : m_tileBlocks[z]) {
-                const TileBlock& block = it.second;
+            m_tileBlocks[z].forEachBlock([&](const TileBlock& block) {
                 for(const TilePtr& tile : block.getTiles()) {
                     if(!tile || tile->isEmpty())
                         continue;
@@ -524,7 +642,7 @@ void Map::saveOtcm(const std::string& fileName)
                     // end of tile
                     fin->addU16(0xFFFF);
                 }
-            }
+            });
         }
 
         // end of file
@@ -23,7 +23,10 @@
 #include <client/manager/spritemanager.h>
 #include <framework/core/filestream.h>
 #include <framework/core/resourcemanager.h>
+#include <framework/graphics/graphics.h>
+#include <framework/graphics/painter.h>
 #include <framework/graphics/image.h>
+#include <framework/platform/platform.h>
 #include <client/game.h>
 
 SpriteManager g_sprites;
@@ -37,6 +40,7 @@ SpriteManager::SpriteManager()
 void SpriteManager::terminate()
 {
     unload();
+    m_atlas.terminate();
 }
 
 bool SpriteManager::loadSpr(std::string file)
@@ -44,21 +48,51 @@ bool SpriteManager::loadSpr(std::string file)
     m_spritesCount = 0;
     m_signature = 0;
     m_loaded = false;
+    cancelPrefetch();
+    releaseSpritesData();
     try {
         file = g_resources.guessFilePath(file, "spr");
+        m_spritesFileName = g_resources.resolvePath(file);
+
+        // map the file when it is a plain file on disk, this avoids keeping a copy of it in memory
+        m_mappedData = g_platform.mapFile(g_resources.getRealPath(m_spritesFileName), m_spritesSize);
+        if(m_mappedData)
+            m_spritesData = m_mappedData;
+        else {
+            m_spritesBuffer = g_resources.readFileContents(m_spritesFileName);
+            m_spritesData = reinterpret_cast<const uint8*>(m_spritesBuffer.data());
+            m_spritesSize = m_spritesBuffer.size();
+        }
+
+        if(m_spritesSize < 8)
+            stdext::throw_exception("invalid sprites file");
 
-        m_spritesFile = g_resources.openFile(file);
-        // cache file buffer to avoid lags from hard drive
-        m_spritesFile->cache();
+        m_signature = stdext::readULE32(m_spritesData);
+        const uint32 spritesCount = stdext::readULE32(m_spritesData + 4);
+        if(spritesCount > (m_spritesSize - 8) / 4)
+            stdext::throw_exception("sprites offset table exceeds file size");
 
-        m_signature = m_spritesFile->getU32();
-        m_spritesCount = m_spritesFile->getU32();
-        m_spritesOffset = m_spritesFile->tell();
+        m_spritesOffsets.resize(spritesCount);
+        const uint8* offsets = m_spritesData + 8;
+        for(uint32 i = 0; i < spritesCount; ++i)
+            m_spritesOffsets[i] = stdext::readULE32(offsets + i * 4);
+
+        m_spritesCount = spritesCount;
         m_loaded = true;
+
+        // images of the previous sprites are not valid anymore
+        if(!m_atlas.isEnabled())
+            m_atlas.init(Size(std::min<int>(ATLAS_PAGE_SIZE, g_graphics.getMaxTextureSize())), ATLAS_MAX_PAGES);
+        else
+            m_atlas.clear();
+
         g_lua.callGlobalField("g_sprites", "onLoadSpr", file);
         return true;
     } catch(stdext::exception& e) {
         g_logger.error(stdext::format("Failed to load sprites from '%s': %s", file, e.what()));
+        releaseSpritesData();
+        m_signature = 0;
+        m_spritesCount = 0;
         return false;
     }
 }
@@ -69,6 +103,12 @@ void SpriteManager::saveSpr(const std::string& fileName)
         stdext::throw_exception("failed to save, spr is not loaded");
 
     try {
+        // overwriting a mapped file would invalidate the mapping, keep a copy in memory instead
+        if(m_mappedData && g_resources.resolvePath(fileName) == m_spritesFileName) {
+            cancelPrefetch();
+            unmapSpritesData();
+        }
+
         FileStreamPtr fin = g_resources.createFile(fileName);
         if(!fin)
             stdext::throw_exception(stdext::format("failed to open file '%s' for write", fileName));
@@ -84,23 +124,18 @@ void SpriteManager::saveSpr(const std::string& fileName)
             fin->addU32(0);
 
         for(int i = 1; i <= m_spritesCount; ++i) {
-            m_spritesFile->seek((i - 1) * 4 + m_spritesOffset);
-            const uint32 fromAdress = m_spritesFile->getU32();
-            if(fromAdress != 0) {
+            const uint32 fromAdress = m_spritesOffsets[i - 1];
+            if(fromAdress != 0 && static_cast<size_t>(fromAdress) + 5 <= m_spritesSize) {
                 fin->seek(offset + (i - 1) * 4);
                 fin->addU32(spriteAddress);
                 fin->seek(spriteAddress);
 
-                m_spritesFile->seek(fromAdress);
-                fin->addU8(m_spritesFile->getU8());
-                fin->addU8(m_spritesFile->getU8());
-                fin->addU8(m_spritesFile->getU8());
-
-                const uint16 dataSize = m_spritesFile->getU16();
+                // color key, data size and pixel data are copied as is
+                const uint8* spriteData = m_spritesData + fromAdress;
+                const uint16 dataSize = std::min<size_t>(stdext::readULE16(spriteData + 3), m_spritesSize - fromAdress - 5);
+                fin->write(spriteData, 3);
                 fin->addU16(dataSize);
-                char spriteData[SPRITE_DATA_SIZE];
-                m_spritesFile->read(spriteData, dataSize);
-                fin->write(spriteData, dataSize);
+                fin->write(spriteData + 5, dataSize);
 
                 spriteAddress = fin->tell();
             }
@@ -116,82 +151,212 @@ void SpriteManager::saveSpr(const std::string& fileName)
 
 void SpriteManager::unload()
 {
+    cancelPrefetch();
     m_spritesCount = 0;
     m_signature = 0;
-    m_spritesFile = nullptr;
+    releaseSpritesData();
+    m_atlas.clear();
 }
 
-ImagePtr SpriteManager::getSpriteImage(int id)
+void SpriteManager::releaseSpritesData()
 {
-    try {
-        if(id == 0 || !m_spritesFile)
-            return nullptr;
-
-        m_spritesFile->seek(((id - 1) * 4) + m_spritesOffset);
-
-        const uint32 spriteAddress = m_spritesFile->getU32();
-
-        // no sprite? return an empty texture
-        if(spriteAddress == 0)
-            return nullptr;
-
-        m_spritesFile->seek(spriteAddress);
-
-        // skip color key
-        m_spritesFile->getU8();
-        m_spritesFile->getU8();
-        m_spritesFile->getU8();
-
-        const uint16 pixelDataSize = m_spritesFile->getU16();
-
-        ImagePtr image(new Image(Size(SPRITE_SIZE, SPRITE_SIZE)));
-
-        uint8* pixels = image->getPixelData();
-        int writePos = 0;
-        int read = 0;
-        const bool useAlpha = g_game.getFeature(Otc::GameSpritesAlphaChannel);
-        const uint8 channels = useAlpha ? 4 : 3;
-        // decompress pixels
-        while(read < pixelDataSize && writePos < SPRITE_DATA_SIZE) {
-            const uint16 transparentPixels = m_spritesFile->getU16();
-            const uint16 coloredPixels = m_spritesFile->getU16();
-            if(!image->hasTransparentPixel())
-                image->setTransparentPixel(transparentPixels > 0);
-            for(int i = 0; i < transparentPixels && writePos < SPRITE_DATA_SIZE; ++i) {
-                pixels[writePos + 0] = 0x00;
-                pixels[writePos + 1] = 0x00;
-                pixels[writePos + 2] = 0x00;
-                pixels[writePos + 3] = 0x00;
-                writePos += 4;
-            }
+    g_platform.unmapFile(m_mappedData, m_spritesSize);
+    m_mappedData = nullptr;
+    m_spritesData = nullptr;
+    m_spritesSize = 0;
+    m_spritesFileName.clear();
+    std::string().swap(m_spritesBuffer);
+    std::vector<uint32>().swap(m_spritesOffsets);
+}
 
-            for(int i = 0; i < coloredPixels && writePos < SPRITE_DATA_SIZE; ++i) {
-                pixels[writePos + 0] = m_spritesFile->getU8();
-                pixels[writePos + 1] = m_spritesFile->getU8();
-                pixels[writePos + 2] = m_spritesFile->getU8();
-                pixels[writePos + 3] = useAlpha ? m_spritesFile->getU8() : 0xFF;
-                writePos += 4;
-            }
+void SpriteManager::unmapSpritesData()
+{
+    if(!m_mappedData)
+        return;
+
+    m_spritesBuffer.assign(reinterpret_cast<const char*>(m_mappedData), m_spritesSize);
+    g_platform.unmapFile(m_mappedData, m_spritesSize);
+    m_mappedData = nullptr;
+    m_spritesData = reinterpret_cast<const uint8*>(m_spritesBuffer.data());
+}
+
+bool SpriteManager::decodeSprite(int id, uint8* pixels, bool* hasTransparentPixel)
+{
+    if(id <= 0 || id > m_spritesCount)
+        return false;
+
+    const uint32 spriteAddress = m_spritesOffsets[id - 1];
+
+    // no sprite? return an empty texture
+    if(spriteAddress == 0 || static_cast<size_t>(spriteAddress) + 5 > m_spritesSize)
+        return false;
 
-            read += 4 + (channels * coloredPixels);
+    // skip color key
+    const uint8* data = m_spritesData + spriteAddress + 3;
+    const uint16 pixelDataSize = stdext::readULE16(data);
+    data += 2;
+
+    const uint8* dataEnd = data + std::min<size_t>(pixelDataSize, m_spritesSize - spriteAddress - 5);
+    uint8* const pixelsEnd = pixels + SPRITE_DATA_SIZE;
+    uint8* writePos = pixels;
+
+    const bool useAlpha = g_game.getFeature(Otc::GameSpritesAlphaChannel);
+    const uint8 channels = useAlpha ? 4 : 3;
+    bool transparent = false;
+
+    // decompress pixels, each chunk is a run of transparent pixels followed by a run of colored pixels
+    while(dataEnd - data >= 4 && writePos < pixelsEnd) {
+        const size_t transparentPixels = stdext::readULE16(data);
+        const size_t coloredPixels = stdext::readULE16(data + 2);
+        data += 4;
+
+        if(transparentPixels > 0) {
+            transparent = true;
+            const size_t bytes = std::min<size_t>(transparentPixels * 4, pixelsEnd - writePos);
+            memset(writePos, 0, bytes);
+            writePos += bytes;
         }
 
-        // Error margin for 4 pixel transparent
-        if(writePos + 4 < SPRITE_DATA_SIZE && !image->hasTransparentPixel())
-            image->setTransparentPixel(true);
-
-        // fill remaining pixels with alpha
-        while(writePos < SPRITE_DATA_SIZE) {
-            pixels[writePos + 0] = 0x00;
-            pixels[writePos + 1] = 0x00;
-            pixels[writePos + 2] = 0x00;
-            pixels[writePos + 3] = 0x00;
-            writePos += 4;
+        const size_t count = std::min<size_t>({ coloredPixels, static_cast<size_t>(pixelsEnd - writePos) / 4, static_cast<size_t>(dataEnd - data) / channels });
+        if(useAlpha)
+            memcpy(writePos, data, count * 4);
+        else {
+            const uint8* src = data;
+            uint8* dest = writePos;
+            for(size_t i = 0; i < count; ++i, src += 3, dest += 4) {
+                dest[0] = src[0];
+                dest[1] = src[1];
+                dest[2] = src[2];
+                dest[3] = 0xFF;
+            }
         }
 
-        return image;
-    } catch(stdext::exception& e) {
-        g_logger.error(stdext::format("Failed to get sprite id %d: %s", id, e.what()));
+        writePos += count * 4;
+        data += std::min<size_t>(coloredPixels * channels, dataEnd - data);
+    }
+
+    // Error margin for 4 pixel transparent
+    if(writePos + 4 < pixelsEnd)
+        transparent = true;
+
+    // fill remaining pixels with alpha
+    memset(writePos, 0, pixelsEnd - writePos);
+
+    if(hasTransparentPixel)
+        *hasTransparentPixel = transparent;
+    return true;
+}
+
+ImagePtr SpriteManager::getSpriteImage(int id, bool* outOfRange)
+{
+    if(id == 0 || !m_spritesData)
+        return nullptr;
+
+    if(id < 0 || id > m_spritesCount) {
+        if(outOfRange)
+            *outOfRange = true;
+        else
+            g_logger.error(stdext::format("Failed to get sprite id %d: out of range", id));
         return nullptr;
     }
+
+    if(m_spritesOffsets[id - 1] == 0)
+        return nullptr;
+
+    ImagePtr image(new Image(Size(SPRITE_SIZE, SPRITE_SIZE)));
+
+    bool transparent = false;
+    if(!decodeSprite(id, image->getPixelData(), &transparent))
+        return nullptr;
+
+    image->setTransparentPixel(transparent);
+    return image;
+}
+
+void SpriteManager::prefetchTexture(const ThingTypePtr& thingType)
+{
+    if(!m_atlas.isEnabled() || !canPrefetch() || thingType->isNull())
+        return;
+
+    for(int phase = 0; phase < thingType->getAnimationPhases(); ++phase) {
+        if(!canPrefetch())
+            return;
+
+        if(thingType->isTextureLoaded(phase) || !thingType->canBuildTextureAsync(phase))
+            continue;
+
+        // the worker only gets a raw pointer, the job keeps the reference on this thread
+        ThingType* rawThingType = thingType.get();
+        const auto it = m_prefetchJobs.emplace(PrefetchKey(rawThingType, phase), PrefetchJob());
+        if(!it.second)
+            continue;
+
+        PrefetchJob& job = it.first->second;
+        job.thingType = thingType;
+        job.started = std::make_shared<std::atomic<bool>>(false);
+
+        const auto started = job.started;
+        job.result = g_asyncDispatcher.schedule([rawThingType, phase, started]() {
+            ThingType::TextureImage textureImage;
+            if(!started->exchange(true))
+                rawThingType->buildTextureImage(phase, false, textureImage);
+            return textureImage;
+        });
+    }
+}
+
+bool SpriteManager::takePrefetch(ThingType* thingType, int animationPhase, ThingType::TextureImage& textureImage)
+{
+    const auto it = m_prefetchJobs.find(PrefetchKey(thingType, animationPhase));
+    if(it == m_prefetchJobs.end())
+        return false;
+
+    // not started yet, building it here is faster than waiting for a worker to pick it
+    const PrefetchJob job = std::move(it->second);
+    m_prefetchJobs.erase(it);
+    if(!job.started->exchange(true))
+        return false;
+
+    textureImage = job.result.get();
+    return textureImage.image != nullptr;
+}
+
+void SpriteManager::pollPrefetch()
+{
+    if(m_prefetchJobs.empty())
+        return;
+
+    const uint32 frame = g_painter->getFrameCount();
+    if(m_prefetchFrame != frame) {
+        m_prefetchFrame = frame;
+        m_prefetchUploads = 0;
+    }
+
+    for(auto it = m_prefetchJobs.begin(); it != m_prefetchJobs.end() && m_prefetchUploads < PREFETCH_UPLOADS_PER_FRAME;) {
+        PrefetchJob& job = it->second;
+        if(!job.result.is_ready()) {
+            ++it;
+            continue;
+        }
+
+        const int animationPhase = it->first.second;
+        if(!job.thingType->isTextureLoaded(animationPhase)) {
+            const ThingType::TextureImage& textureImage = job.result.get();
+            if(textureImage.image) {
+                Point atlasOffset;
+                job.thingType->setTextureImage(animationPhase, false, textureImage, atlasOffset);
+                ++m_prefetchUploads;
+            }
+        }
+
+        it = m_prefetchJobs.erase(it);
+    }
+}
+
+void SpriteManager::cancelPrefetch()
+{
+    // workers read the sprites data, wait for them before it goes away
+    for(auto& it : m_prefetchJobs)
+        it.second.result.wait();
+    m_prefetchJobs.clear();
 }
@@ -26,6 +26,9 @@
 #include <client/config.h>
 #include <framework/core/declarations.h>
 #include <framework/graphics/declarations.h>
+#include <framework/graphics/textureatlas.h>
+#include <framework/core/asyncdispatcher.h>
+#include <client/thing/type/thingtype.h>
 
  //@bindsingleton g_sprites
 class SpriteManager
@@ -47,15 +50,66 @@ public:
     uint32 getSignature() { return m_signature; }
     int getSpritesCount() { return m_spritesCount; }
 
-    ImagePtr getSpriteImage(int id);
+    // with outOfRange the error is left to the caller, worker threads must not log
+    ImagePtr getSpriteImage(int id, bool* outOfRange = nullptr);
+    bool decodeSprite(int id, uint8* pixels, bool* hasTransparentPixel = nullptr);
     bool isLoaded() { return m_loaded; }
+    bool isMapped() { return m_mappedData != nullptr; }
+
+    TextureAtlas& getAtlas() { return m_atlas; }
+    int getAtlasPageCount() { return m_atlas.getPageCount(); }
+    uint32 getAtlasEvictions() { return m_atlas.getFrameEvictions(); }
+
+    // thing type textures of things arriving on the map are composed by g_asyncDispatcher
+    // workers, the render thread only uploads a few of them each frame
+    void prefetchTexture(const ThingTypePtr& thingType);
+    // hands over the pending job of a texture about to be drawn, false when it must be built by the caller
+    bool takePrefetch(ThingType* thingType, int animationPhase, ThingType::TextureImage& textureImage);
+    bool canPrefetch() { return m_loaded && m_prefetchJobs.size() < PREFETCH_MAX_IN_FLIGHT; }
+    void pollPrefetch();
+    void cancelPrefetch();
+    int getPrefetchInFlight() { return m_prefetchJobs.size(); }
+    uint32 getPrefetchUploads() { return m_prefetchUploads; }
 
 private:
+    enum {
+        ATLAS_PAGE_SIZE = 2048,
+        ATLAS_MAX_PAGES = 8,
+        PREFETCH_MAX_IN_FLIGHT = 64,
+        PREFETCH_UPLOADS_PER_FRAME = 8
+    };
+
+    struct PrefetchJob {
+        ThingTypePtr thingType;
+        // set by whoever builds the texture, the worker or the render thread taking it over
+        std::shared_ptr<std::atomic<bool>> started;
+        boost::shared_future<ThingType::TextureImage> result;
+    };
+
+    using PrefetchKey = std::pair<ThingType*, int>;
+    struct PrefetchKeyHasher {
+        size_t operator()(const PrefetchKey& key) const { return std::hash<ThingType*>()(key.first) ^ key.second; }
+    };
+
+    void releaseSpritesData();
+    void unmapSpritesData();
+
     bool m_loaded{ false };
     uint32 m_signature;
     int m_spritesCount{ 0 };
-    int m_spritesOffset{ 0 };
-    FileStreamPtr m_spritesFile;
+    std::string m_spritesFileName;
+    // sprites are decoded straight from the mapped file, when the file
+    // can't be mapped (e.g. it lives inside an archive) it is read into m_spritesBuffer
+    const uint8* m_spritesData{ nullptr };
+    size_t m_spritesSize{ 0 };
+    const uint8* m_mappedData{ nullptr };
+    std::string m_spritesBuffer;
+    std::vector<uint32> m_spritesOffsets;
+    TextureAtlas m_atlas;
+
+    std::unordered_map<PrefetchKey, PrefetchJob, PrefetchKeyHasher> m_prefetchJobs;
+    uint32 m_prefetchFrame{ 0 };
+    uint32 m_prefetchUploads{ 0 };
 };
 
 extern SpriteManager g_sprites;
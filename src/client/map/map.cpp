@@ -26,6 +26,7 @@
 #include <client/thing/creature/localplayer.h>
 #include <client/map/mapview.h>
 #include <client/map/minimap.h>
+#include <client/manager/spritemanager.h>
 #include <client/thing/missile.h>
 #include <client/thing/text/statictext.h>
 #include <client/map/tile.h>
@@ -35,6 +36,7 @@
 #include <framework/graphics/graphics.h>
 #include <framework/core/application.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/core/framearena.h>
 
 Map g_map;
 TilePtr Map::m_nulltile;
@@ -50,6 +52,7 @@ void Map::init()
 void Map::terminate()
 {
     g_lightViewPaint.terminate();
+    cancelAllPathFinds();
     clean();
 }
 
@@ -105,8 +108,10 @@ void Map::clean()
 {
     cleanDynamicThings();
 
-    for(int_fast8_t i = -1; ++i <= MAX_Z;)
+    for(int_fast8_t i = -1; ++i <= MAX_Z;) {
         m_tileBlocks[i].clear();
+        m_creatureTiles[i].clear();
+    }
 
     m_waypoints.clear();
 
@@ -151,6 +156,9 @@ void Map::addThing(const ThingPtr& thing, const Position& pos, int16 stackPos)
             }
 
             tile->addThing(thing, stackPos);
+
+            // compose its textures on the workers before it gets drawn
+            g_sprites.prefetchTexture(thing->getThingType());
         }
         return;
     }
@@ -309,7 +317,7 @@ const TilePtr& Map::createTile(const Position& pos)
     if(pos.y > m_tilesRect.bottom())
         m_tilesRect.setBottom(pos.y);
 
-    TileBlock& block = m_tileBlocks[pos.z][getBlockIndex(pos)];
+    TileBlock& block = m_tileBlocks[pos.z].getOrCreateBlock(pos);
     return block.create(pos);
 }
 
@@ -343,7 +351,7 @@ const TilePtr& Map::getOrCreateTile(const Position& pos)
     if(pos.y > m_tilesRect.bottom())
         m_tilesRect.setBottom(pos.y);
 
-    TileBlock& block = m_tileBlocks[pos.z][getBlockIndex(pos)];
+    TileBlock& block = m_tileBlocks[pos.z].getOrCreateBlock(pos);
     return block.getOrCreate(pos);
 }
 
@@ -352,11 +360,7 @@ const TilePtr& Map::getTile(const Position& pos)
     if(!pos.isMapPosition())
         return m_nulltile;
 
-    auto it = m_tileBlocks[pos.z].find(getBlockIndex(pos));
-    if(it != m_tileBlocks[pos.z].end())
-        return it->second.get(pos);
-
-    return m_nulltile;
+    return m_tileBlocks[pos.z].get(pos, m_nulltile);
 }
 
 const TileList Map::getTiles(const int8 floor/* = -1*/)
@@ -367,22 +371,20 @@ const TileList Map::getTiles(const int8 floor/* = -1*/)
     if(floor < 0) {
         // Search all floors
         for(int_fast8_t z = -1; ++z <= MAX_Z;) {
-            for(const auto& pair : m_tileBlocks[z]) {
-                const TileBlock& block = pair.second;
+            m_tileBlocks[z].forEachBlock([&](const TileBlock& block) {
                 for(const TilePtr& tile : block.getTiles()) {
                     if(tile != nullptr)
                         tiles.push_back(tile);
                 }
-            }
+            });
         }
     } else {
-        for(const auto& pair : m_tileBlocks[floor]) {
-            const TileBlock& block = pair.second;
+        m_tileBlocks[floor].forEachBlock([&](const TileBlock& block) {
             for(const TilePtr& tile : block.getTiles()) {
                 if(tile != nullptr)
                     tiles.push_back(tile);
             }
-        }
+        });
     }
 
     return tiles;
@@ -393,13 +395,11 @@ void Map::cleanTile(const Position& pos)
     if(!pos.isMapPosition())
         return;
 
-    auto it = m_tileBlocks[pos.z].find(getBlockIndex(pos));
-    if(it != m_tileBlocks[pos.z].end()) {
-        TileBlock& block = it->second;
-        if(const TilePtr& tile = block.get(pos)) {
+    if(TileBlock* block = m_tileBlocks[pos.z].findBlock(pos)) {
+        if(const TilePtr& tile = block->get(pos)) {
             tile->clean();
             if(tile->canErase())
-                block.remove(pos);
+                block->remove(pos);
 
             notificateTileUpdate(pos);
         }
@@ -490,8 +490,7 @@ std::map<Position, ItemPtr> Map::findItemsById(uint16 clientId, uint32 max)
     std::map<Position, ItemPtr> ret;
     uint32 count = 0;
     for(uint8_t z = 0; z <= MAX_Z; ++z) {
-        for(const auto& pair : m_tileBlocks[z]) {
-            const TileBlock& block = pair.second;
+        m_tileBlocks[z].forEachBlock([&](const TileBlock& block) {
             for(const TilePtr& tile : block.getTiles()) {
                 if(unlikely(!tile || tile->isEmpty()))
                     continue;
@@ -503,7 +502,7 @@ std::map<Position, ItemPtr> Map::findItemsById(uint16 clientId, uint32 max)
                     }
                 }
             }
-        }
+        });
     }
 
     return ret;
@@ -554,9 +553,7 @@ void Map::removeUnawareThings()
     if(!g_game.getFeature(Otc::GameKeepUnawareTiles)) {
         // remove tiles that we are not aware anymore
         for(int_fast8_t z = -1; ++z <= MAX_Z;) {
-            std::unordered_map<uint, TileBlock>& tileBlocks = m_tileBlocks[z];
-            for(auto it = tileBlocks.begin(); it != tileBlocks.end();) {
-                TileBlock& block = (*it).second;
+            m_tileBlocks[z].removeBlocksIf([&](TileBlock& block) {
                 bool blockEmpty = true;
                 for(const TilePtr& tile : block.getTiles()) {
                     if(!tile) continue;
@@ -569,12 +566,8 @@ void Map::removeUnawareThings()
 
                     block.remove(pos);
                 }
-
-                if(blockEmpty)
-                    it = tileBlocks.erase(it);
-                else
-                    ++it;
-            }
+                return blockEmpty;
+            });
         }
     }
 }
@@ -636,28 +629,75 @@ std::vector<CreaturePtr> Map::getSpectatorsInRange(const Position& centerPos, bo
     return getSpectatorsInRangeEx(centerPos, multiFloor, xRange, xRange, yRange, yRange);
 }
 
-std::vector<CreaturePtr> Map::getSpectatorsInRangeEx(const Position& centerPos, bool multiFloor, int32 minXRange, int32 maxXRange, int32 minYRange, int32 maxYRange)
+std::vector<CreaturePtr> Map::getSpectatorsInRangeEx(const Position& centerPos, bool multiFloor, int32 minXRange, int32 maxXRange, int32 minYRange, int32 maxYRange, bool orderByDistance)
 {
     std::vector<CreaturePtr> creatures;
+    forEachSpectatorInRange(centerPos, multiFloor, minXRange, maxXRange, minYRange, maxYRange, [&](Creature* creature) {
+        creatures.emplace_back(creature);
+    }, orderByDistance);
+
+    return creatures;
+}
+
+void Map::forEachSpectatorInRange(const Position& centerPos, bool multiFloor, int32 minXRange, int32 maxXRange, int32 minYRange, int32 maxYRange, const SpectatorVisitor& visitor, bool orderByDistance)
+{
     const uint8 maxZRange = multiFloor ? MAX_Z : 0;
 
-    //TODO: optimize
     //TODO: get creatures from other floors corretly
-    //TODO: delivery creatures in distance order
+    // only tiles holding creatures are visited, in the same order as a scan of the range
+    FrameVector<Position> positions(&g_frameArena);
     for(int_fast8_t iz = -1; ++iz <= maxZRange;) {
-        for(int_fast32_t iy = -minYRange; iy <= maxYRange; ++iy) {
-            for(int_fast32_t ix = -minXRange; ix <= maxXRange; ++ix) {
-                TilePtr tile = getTile(centerPos.translated(ix, iy, iz));
-                if(!tile)
-                    continue;
+        const int z = centerPos.z + iz;
+        if(z > MAX_Z)
+            break;
 
-                auto tileCreatures = tile->getCreatures();
-                creatures.insert(creatures.end(), tileCreatures.rbegin(), tileCreatures.rend());
+        auto& floorTiles = m_creatureTiles[z];
+        for(size_t i = 0; i < floorTiles.size();) {
+            const Position& pos = floorTiles[i];
+
+            // drop positions of tiles that were released meanwhile
+            const TilePtr& tile = getTile(pos);
+            if(!tile || !tile->hasCreature()) {
+                floorTiles[i] = floorTiles.back();
+                floorTiles.pop_back();
+                continue;
             }
+
+            const int dx = pos.x - centerPos.x, dy = pos.y - centerPos.y;
+            if(dx >= -minXRange && dx <= maxXRange && dy >= -minYRange && dy <= maxYRange)
+                positions.push_back(pos);
+            ++i;
         }
     }
 
-    return creatures;
+    std::sort(positions.begin(), positions.end(), [](const Position& a, const Position& b) {
+        return std::tie(a.z, a.y, a.x) < std::tie(b.z, b.y, b.x);
+    });
+
+    if(orderByDistance) {
+        std::stable_sort(positions.begin(), positions.end(), [&](const Position& a, const Position& b) {
+            return a.distance(centerPos) < b.distance(centerPos);
+        });
+    }
+
+    for(const Position& pos : positions)
+        getTile(pos)->forEachCreatureFromTop(visitor);
+}
+
+void Map::updateCreatureTile(const Position& pos, bool hasCreature)
+{
+    if(!pos.isMapPosition())
+        return;
+
+    auto& floorTiles = m_creatureTiles[pos.z];
+    const auto it = std::find(floorTiles.begin(), floorTiles.end(), pos);
+    if(hasCreature) {
+        if(it == floorTiles.end())
+            floorTiles.push_back(pos);
+    } else if(it != floorTiles.end()) {
+        *it = floorTiles.back();
+        floorTiles.pop_back();
+    }
 }
 
 bool Map::isLookPossible(const Position& pos)
@@ -671,13 +711,13 @@ bool Map::isCovered(const Position& pos, uint8 firstFloor)
     // check for tiles on top of the postion
     Position tilePos = pos;
     while(tilePos.coveredUp() && tilePos.z >= firstFloor) {
-        TilePtr tile = getTile(tilePos);
+        auto& floor = m_tileBlocks[tilePos.z];
+
         // the below tile is covered when the above tile has a full opaque
-        if(tile && tile->isFullyOpaque())
+        if(floor.isFullyOpaque(tilePos))
             return true;
 
-        tile = getTile(tilePos.translated(1, 1));
-        if(tile && tile->isTopGround())
+        if(floor.isTopGround(tilePos.translated(1, 1)))
             return true;
     }
     return false;
@@ -686,49 +726,33 @@ bool Map::isCovered(const Position& pos, uint8 firstFloor)
 bool Map::isCompletelyCovered(const Position& pos, uint8 firstFloor)
 {
     const TilePtr& checkTile = getTile(pos);
+    const bool singleDimension = !checkTile || checkTile->isSingleDimension();
+
     Position tilePos = pos;
     while(tilePos.coveredUp() && tilePos.z >= firstFloor) {
-        bool covered = true;
-        bool done = false;
-
-        // Check is Top Ground
-        for(int_fast8_t x = -1; ++x < 2 && !done;) {
-            for(int_fast8_t y = -1; ++y < 2 && !done;) {
-                const TilePtr& tile = getTile(tilePos.translated(x, x));
-                if(!tile || !tile->isTopGround()) {
-                    covered = false;
-                    done = true;
-                } else if(x == 1 && y == 1 && (!checkTile || checkTile->isSingleDimension())) {
-                    done = true;
-                }
-            }
-        }
+        auto& floor = m_tileBlocks[tilePos.z];
 
-        if(covered)
+        // check is top ground
+        if(floor.isTopGround(tilePos) && floor.isTopGround(tilePos.translated(1, 1)))
             return true;
 
-        covered = true;
-        done = false;
-
         // check in 2x2 range tiles that has no transparent pixels
-        for(int_fast8_t x = -1; ++x < 2 && !done;) {
-            for(int_fast8_t y = -1; ++y < 2 && !done;) {
-                const TilePtr& tile = getTile(tilePos.translated(-x, -y));
-                if(!tile || !tile->isFullyOpaque()) {
-                    covered = false;
-                    done = true;
-                } else if(x == 0 && y == 0 && (!checkTile || checkTile->isSingleDimension())) {
-                    done = true;
-                }
-            }
-        }
-
-        if(covered)
+        if(floor.isFullyOpaque(tilePos) && (singleDimension ||
+           (floor.isFullyOpaque(tilePos.translated(0, -1)) && floor.isFullyOpaque(tilePos.translated(-1, 0)) && floor.isFullyOpaque(tilePos.translated(-1, -1)))))
             return true;
     }
     return false;
 }
 
+void Map::updateOccluder(const Position& pos, bool fullyOpaque, bool topGround)
+{
+    if(!pos.isMapPosition())
+        return;
+
+    if(TileBlock* block = m_tileBlocks[pos.z].findBlock(pos))
+        block->setOccluder(pos, fullyOpaque, topGround);
+}
+
 bool Map::isAwareOfPosition(const Position& pos)
 {
     if(pos.z < getFirstAwareFloor() || pos.z > getLastAwareFloor())
@@ -775,176 +799,367 @@ uint8 Map::getLastAwareFloor()
     return SEA_FLOOR;
 }
 
-std::tuple<std::vector<Otc::Direction_t>, Otc::PathFindResult_t> Map::findPath(const Position& startPos, const Position& goalPos, uint16 maxComplexity, uint32 flags)
+namespace
 {
-    // pathfinding using A* search algorithm
-    // as described in http://en.wikipedia.org/wiki/A*_search_algorithm
-
-    struct Node {
-        using Pair = std::pair<Node*, float>;
-
-        Node(const Position& pos) : cost(0), totalCost(0), pos(pos), prev(nullptr), dir(Otc::InvalidDirection) {}
-        float cost;
-        float totalCost;
-        Position pos;
-        Node* prev;
-        Otc::Direction_t dir;
-
-        struct Compare {
-            bool operator() (const Pair& a, const Pair& b) const
-            {
-                return b.second < a.second;
-            }
-        };
+    enum PathTileFlags : uint8 {
+        PathTileFetched = 1 << 0,
+        PathTileWasSeen = 1 << 1,
+        PathTileHasCreature = 1 << 2,
+        PathTileNotWalkable = 1 << 3,
+        PathTileNotPathable = 1 << 4
     };
 
-    std::tuple<std::vector<Otc::Direction_t>, Otc::PathFindResult_t> ret;
-    std::vector<Otc::Direction_t>& dirs = std::get<0>(ret);
-    Otc::PathFindResult_t& result = std::get<1>(ret);
-
-    result = Otc::PathFindResultNoWay;
+    // walk info of a position, flags are 0 while it wasn't fetched
+    struct PathTile {
+        uint16 speed;
+        uint8 flags;
+    };
 
-    if(startPos == goalPos) {
-        result = Otc::PathFindResultSamePosition;
-        return ret;
+    PathTile getMinimapPathTile(const MinimapTile& mtile)
+    {
+        PathTile pathTile{ 100, PathTileFetched };
+        if(mtile.hasFlag(MinimapTileNotWalkable))
+            pathTile.flags |= PathTileNotWalkable;
+        if(mtile.hasFlag(MinimapTileNotPathable))
+            pathTile.flags |= PathTileNotPathable;
+        if(mtile.hasFlag(MinimapTileWasSeen) || (pathTile.flags & (PathTileNotWalkable | PathTileNotPathable)))
+            pathTile.flags |= PathTileWasSeen;
+        pathTile.speed = mtile.getSpeed();
+        return pathTile;
     }
 
-    if(startPos.z != goalPos.z) {
-        result = Otc::PathFindResultImpossible;
-        return ret;
+    PathTile fetchPathTile(const Position& pos, uint32 flags)
+    {
+        PathTile pathTile{ 100, PathTileFetched };
+        if(g_map.isAwareOfPosition(pos)) {
+            pathTile.flags |= PathTileWasSeen;
+            if(const TilePtr& tile = g_map.getTile(pos)) {
+                if(tile->hasCreature())
+                    pathTile.flags |= PathTileHasCreature;
+                if(!tile->isWalkable(flags & Otc::PathFindAllowCreatures))
+                    pathTile.flags |= PathTileNotWalkable;
+                if(!tile->isPathable())
+                    pathTile.flags |= PathTileNotPathable;
+                pathTile.speed = tile->getGroundSpeed();
+            } else
+                pathTile.flags |= PathTileNotWalkable | PathTileNotPathable;
+        } else
+            pathTile = getMinimapPathTile(g_minimap.getTile(pos));
+        return pathTile;
     }
 
-    // check the goal pos is walkable
-    if(g_map.isAwareOfPosition(goalPos)) {
-        const TilePtr goalTile = getTile(goalPos);
-        if(!goalTile || !goalTile->isWalkable((flags & Otc::PathFindAllowCreatures))) {
-            return ret;
+    // checks done before searching, returns false when there is nothing to search
+    bool canSearchPath(const Position& startPos, const Position& goalPos, uint32 flags, Otc::PathFindResult_t& result)
+    {
+        result = Otc::PathFindResultNoWay;
+
+        if(startPos == goalPos) {
+            result = Otc::PathFindResultSamePosition;
+            return false;
         }
-    } else {
-        const MinimapTile& goalTile = g_minimap.getTile(goalPos);
-        if(goalTile.hasFlag(MinimapTileNotWalkable)) {
-            return ret;
+
+        if(startPos.z != goalPos.z) {
+            result = Otc::PathFindResultImpossible;
+            return false;
+        }
+
+        // check the goal pos is walkable
+        if(g_map.isAwareOfPosition(goalPos)) {
+            const TilePtr goalTile = g_map.getTile(goalPos);
+            if(!goalTile || !goalTile->isWalkable((flags & Otc::PathFindAllowCreatures)))
+                return false;
+        } else {
+            const MinimapTile& goalTile = g_minimap.getTile(goalPos);
+            if(goalTile.hasFlag(MinimapTileNotWalkable))
+                return false;
         }
+
+        return true;
     }
 
-    std::unordered_map<Position, Node*, Position::Hasher> nodes;
-    std::priority_queue<Node::Pair, std::deque<Node::Pair>, Node::Compare> searchList;
+    // pathfinding using A* search algorithm
+    // as described in http://en.wikipedia.org/wiki/A*_search_algorithm
+    // fetchTile gives the walk info of a position, it's asked once per position
+    template<typename FetchTile>
+    void searchPath(const Position& startPos, const Position& goalPos, uint16 maxComplexity, uint32 flags, FetchTile&& fetchTile,
+                    std::vector<Otc::Direction_t>& dirs, Otc::PathFindResult_t& result, const std::atomic<bool>* canceled = nullptr)
+    {
+        // explored nodes live in one array and are found through a paged grid around
+        // the start, the open set is a binary heap of node indexes
+        enum : uint32 {
+            PAGE_SIZE = 32,
+            NO_NODE = UINT32_MAX
+        };
 
-    auto currentNode = new Node(startPos);
-    currentNode->pos = startPos;
-    nodes[startPos] = currentNode;
-    Node* foundNode = nullptr;
-    while(currentNode) {
-        if(static_cast<uint16>(nodes.size()) > maxComplexity) {
-            result = Otc::PathFindResultTooFar;
-            break;
-        }
+        struct Node {
+            float cost;
+            float totalCost;
+            Position pos;
+            uint32 prev;
+            Otc::Direction_t dir;
+        };
 
-        // path found
-        if(currentNode->pos == goalPos && (!foundNode || currentNode->cost < foundNode->cost))
-            foundNode = currentNode;
+        struct Cell {
+            uint32 node; // node index + 1, 0 when the position wasn't reached yet
+            PathTile tile;
+        };
 
-        // cost too high
-        if(foundNode && currentNode->totalCost >= foundNode->cost)
-            break;
+        using Page = std::array<Cell, PAGE_SIZE * PAGE_SIZE>;
+        using OpenNode = std::pair<float, uint32>;
+
+        std::vector<Node> nodes;
+        std::vector<OpenNode> searchList;
+        std::unordered_map<uint32, std::unique_ptr<Page>> pages;
+        uint32 lastPageKey = NO_NODE;
+        Page* lastPage = nullptr;
+
+        const auto compareOpenNodes = [](const OpenNode& a, const OpenNode& b) { return b.first < a.first; };
+
+        const auto getCell = [&](const Position& pos) -> Cell& {
+            const uint32 pageKey = (pos.x / PAGE_SIZE) << 16 | (pos.y / PAGE_SIZE);
+            if(pageKey != lastPageKey) {
+                auto& page = pages[pageKey];
+                if(!page)
+                    page.reset(new Page());
+                lastPageKey = pageKey;
+                lastPage = page.get();
+            }
+            return (*lastPage)[(pos.y % PAGE_SIZE) * PAGE_SIZE + (pos.x % PAGE_SIZE)];
+        };
 
-        for(int_fast32_t i = -1; i <= 1; ++i) {
-            for(int_fast32_t j = -1; j <= 1; ++j) {
-                if(i == 0 && j == 0)
-                    continue;
+        nodes.reserve(std::min<uint32>(maxComplexity + 1u, 1024));
+        nodes.push_back(Node{ 0, 0, startPos, NO_NODE, Otc::InvalidDirection });
+        getCell(startPos).node = 1;
 
-                bool wasSeen = false;
-                bool hasCreature = false;
-                bool isNotWalkable = true;
-                bool isNotPathable = true;
-                uint16 speed = 100;
-
-                Position neighborPos = currentNode->pos.translated(i, j);
-                if(g_map.isAwareOfPosition(neighborPos)) {
-                    wasSeen = true;
-                    if(const TilePtr& tile = getTile(neighborPos)) {
-                        hasCreature = tile->hasCreature();
-                        isNotWalkable = !tile->isWalkable(flags & Otc::PathFindAllowCreatures);
-                        isNotPathable = !tile->isPathable();
-                        speed = tile->getGroundSpeed();
-                    }
-                } else {
-                    const MinimapTile& mtile = g_minimap.getTile(neighborPos);
-                    wasSeen = mtile.hasFlag(MinimapTileWasSeen);
-                    isNotWalkable = mtile.hasFlag(MinimapTileNotWalkable);
-                    isNotPathable = mtile.hasFlag(MinimapTileNotPathable);
-                    if(isNotWalkable || isNotPathable)
-                        wasSeen = true;
-                    speed = mtile.getSpeed();
-                }
+        uint32 currentIndex = 0;
+        uint32 foundIndex = NO_NODE;
+        while(currentIndex != NO_NODE) {
+            if(canceled && canceled->load(std::memory_order_relaxed))
+                return;
+
+            if(static_cast<uint16>(nodes.size()) > maxComplexity) {
+                result = Otc::PathFindResultTooFar;
+                break;
+            }
+
+            // nodes may grow below, keep a copy of what is needed from the current one
+            const Position currentPos = nodes[currentIndex].pos;
+            const float currentCost = nodes[currentIndex].cost;
 
-                float walkFactor = 0;
-                if(neighborPos != goalPos) {
-                    if(!(flags & Otc::PathFindAllowNotSeenTiles) && !wasSeen)
+            // path found
+            if(currentPos == goalPos && (foundIndex == NO_NODE || currentCost < nodes[foundIndex].cost))
+                foundIndex = currentIndex;
+
+            // cost too high
+            if(foundIndex != NO_NODE && nodes[currentIndex].totalCost >= nodes[foundIndex].cost)
+                break;
+
+            for(int_fast32_t i = -1; i <= 1; ++i) {
+                for(int_fast32_t j = -1; j <= 1; ++j) {
+                    if(i == 0 && j == 0)
                         continue;
-                    if(wasSeen) {
-                        if(!(flags & Otc::PathFindAllowCreatures) && hasCreature)
-                            continue;
-                        if(!(flags & Otc::PathFindAllowNonPathable) && isNotPathable)
+
+                    const Position neighborPos = currentPos.translated(i, j);
+                    Cell& cell = getCell(neighborPos);
+                    if(!cell.tile.flags)
+                        cell.tile = fetchTile(neighborPos);
+
+                    const bool wasSeen = cell.tile.flags & PathTileWasSeen;
+                    const bool hasCreature = cell.tile.flags & PathTileHasCreature;
+                    const bool isNotWalkable = cell.tile.flags & PathTileNotWalkable;
+                    const bool isNotPathable = cell.tile.flags & PathTileNotPathable;
+
+                    float walkFactor = 0;
+                    if(neighborPos != goalPos) {
+                        if(!(flags & Otc::PathFindAllowNotSeenTiles) && !wasSeen)
                             continue;
-                        if(!(flags & Otc::PathFindAllowNonWalkable) && isNotWalkable)
+                        if(wasSeen) {
+                            if(!(flags & Otc::PathFindAllowCreatures) && hasCreature)
+                                continue;
+                            if(!(flags & Otc::PathFindAllowNonPathable) && isNotPathable)
+                                continue;
+                            if(!(flags & Otc::PathFindAllowNonWalkable) && isNotWalkable)
+                                continue;
+                        }
+                    } else {
+                        if(!(flags & Otc::PathFindAllowNotSeenTiles) && !wasSeen)
                             continue;
+                        if(wasSeen) {
+                            if(!(flags & Otc::PathFindAllowNonWalkable) && isNotWalkable)
+                                continue;
+                        }
                     }
-                } else {
-                    if(!(flags & Otc::PathFindAllowNotSeenTiles) && !wasSeen)
-                        continue;
-                    if(wasSeen) {
-                        if(!(flags & Otc::PathFindAllowNonWalkable) && isNotWalkable)
-                            continue;
-                    }
-                }
 
-                const Otc::Direction_t walkDir = currentNode->pos.getDirectionFromPosition(neighborPos);
-                if(walkDir >= Otc::NorthEast)
-                    walkFactor += 3.0f;
-                else
-                    walkFactor += 1.0f;
-
-                const float cost = currentNode->cost + (speed * walkFactor) / 100.0f;
-
-                Node* neighborNode;
-                if(nodes.find(neighborPos) == nodes.end()) {
-                    neighborNode = new Node(neighborPos);
-                    nodes[neighborPos] = neighborNode;
-                } else {
-                    neighborNode = nodes[neighborPos];
-                    if(neighborNode->cost <= cost)
+                    const Otc::Direction_t walkDir = currentPos.getDirectionFromPosition(neighborPos);
+                    if(walkDir >= Otc::NorthEast)
+                        walkFactor += 3.0f;
+                    else
+                        walkFactor += 1.0f;
+
+                    const float cost = currentCost + (cell.tile.speed * walkFactor) / 100.0f;
+
+                    if(cell.node == 0) {
+                        nodes.push_back(Node{ 0, 0, neighborPos, NO_NODE, Otc::InvalidDirection });
+                        cell.node = nodes.size();
+                    } else if(nodes[cell.node - 1].cost <= cost)
                         continue;
-                }
 
-                neighborNode->prev = currentNode;
-                neighborNode->cost = cost;
-                neighborNode->totalCost = neighborNode->cost + neighborPos.distance(goalPos);
-                neighborNode->dir = walkDir;
-                searchList.emplace(neighborNode, neighborNode->totalCost);
+                    Node& neighborNode = nodes[cell.node - 1];
+                    neighborNode.prev = currentIndex;
+                    neighborNode.cost = cost;
+                    neighborNode.totalCost = neighborNode.cost + neighborPos.distance(goalPos);
+                    neighborNode.dir = walkDir;
+
+                    searchList.emplace_back(neighborNode.totalCost, cell.node - 1);
+                    std::push_heap(searchList.begin(), searchList.end(), compareOpenNodes);
+                }
             }
+
+            if(!searchList.empty()) {
+                std::pop_heap(searchList.begin(), searchList.end(), compareOpenNodes);
+                currentIndex = searchList.back().second;
+                searchList.pop_back();
+            } else
+                currentIndex = NO_NODE;
         }
 
-        if(!searchList.empty()) {
-            currentNode = searchList.top().first;
-            searchList.pop();
-        } else
-            currentNode = nullptr;
+        if(foundIndex != NO_NODE) {
+            for(uint32 index = foundIndex; index != NO_NODE; index = nodes[index].prev)
+                dirs.push_back(nodes[index].dir);
+            dirs.pop_back();
+            std::reverse(dirs.begin(), dirs.end());
+            result = Otc::PathFindResultOk;
+        }
     }
+}
 
-    if(foundNode) {
-        currentNode = foundNode;
-        while(currentNode) {
-            dirs.push_back(currentNode->dir);
-            currentNode = currentNode->prev;
+Map::PathFindResult Map::findPath(const Position& startPos, const Position& goalPos, uint16 maxComplexity, uint32 flags)
+{
+    PathFindResult ret;
+    std::vector<Otc::Direction_t>& dirs = std::get<0>(ret);
+    Otc::PathFindResult_t& result = std::get<1>(ret);
+
+    if(!canSearchPath(startPos, goalPos, flags, result))
+        return ret;
+
+    searchPath(startPos, goalPos, maxComplexity, flags, [flags](const Position& pos) { return fetchPathTile(pos, flags); }, dirs, result);
+    return ret;
+}
+
+uint32 Map::findPathAsync(const Position& startPos, const Position& goalPos, uint16 maxComplexity, uint32 flags, const PathFindCallback& callback)
+{
+    const uint32 requestId = ++m_lastPathFindId;
+
+    PathFindRequest& request = m_pathFindRequests[requestId];
+    request.callback = callback;
+    request.canceled = std::make_shared<std::atomic<bool>>(false);
+
+    // nothing to search, the result is handed over on the next poll without bothering the workers
+    Otc::PathFindResult_t result;
+    if(!canSearchPath(startPos, goalPos, flags, result)) {
+        g_dispatcher.addEvent([this, requestId, result] {
+            const auto it = m_pathFindRequests.find(requestId);
+            if(it == m_pathFindRequests.end())
+                return;
+
+            const PathFindCallback requestCallback = it->second.callback;
+            m_pathFindRequests.erase(it);
+            if(requestCallback)
+                requestCallback(std::vector<Otc::Direction_t>(), result);
+        });
+        return requestId;
+    }
+
+    if(!m_pathFindEvent)
+        m_pathFindEvent = g_dispatcher.cycleEvent([this] { pollPathFinds(); }, PATH_POLL_DELAY);
+
+    // the worker can't touch the map, copy the walk info of the aware tiles of the floor
+    const int awareOffset = std::abs(startPos.z - m_centralPosition.z);
+    const Rect awareRect(m_centralPosition.x - m_awareRange.left - awareOffset, m_centralPosition.y - m_awareRange.top - awareOffset,
+                         m_awareRange.horizontal() + 2 * awareOffset, m_awareRange.vertical() + 2 * awareOffset);
+    auto awareTiles = std::make_shared<std::vector<PathTile>>(awareRect.width() * awareRect.height(), PathTile{ 0, 0 });
+    for(int y = awareRect.top(); y <= awareRect.bottom(); ++y) {
+        for(int x = awareRect.left(); x <= awareRect.right(); ++x) {
+            if(x < 0 || y < 0 || x > UINT16_MAX || y > UINT16_MAX)
+                continue;
+
+            const Position pos(x, y, startPos.z);
+            if(isAwareOfPosition(pos))
+                (*awareTiles)[(y - awareRect.top()) * awareRect.width() + (x - awareRect.left())] = fetchPathTile(pos, flags);
         }
-        dirs.pop_back();
-        std::reverse(dirs.begin(), dirs.end());
-        result = Otc::PathFindResultOk;
     }
 
-    for(auto it : nodes)
-        delete it.second;
+    // and share the minimap blocks around the start and the goal, nothing is known outside of them
+    const int left = std::min<int>(startPos.x, goalPos.x) - PATH_SNAPSHOT_MARGIN, top = std::min<int>(startPos.y, goalPos.y) - PATH_SNAPSHOT_MARGIN;
+    const int right = std::max<int>(startPos.x, goalPos.x) + PATH_SNAPSHOT_MARGIN, bottom = std::max<int>(startPos.y, goalPos.y) + PATH_SNAPSHOT_MARGIN;
+    const Rect box(Point(left, top), Point(right, bottom));
+    auto minimap = std::make_shared<MinimapSnapshot>(g_minimap.snapshot(box, startPos.z));
+
+    const auto canceled = request.canceled;
+    request.result = g_asyncDispatcher.schedule([=] {
+        PathFindResult ret;
+        searchPath(startPos, goalPos, maxComplexity, flags, [&](const Position& pos) {
+            if(!box.contains(Point(pos.x, pos.y)))
+                return PathTile{ 100, PathTileFetched | PathTileWasSeen | PathTileNotWalkable | PathTileNotPathable };
+
+            if(awareRect.contains(Point(pos.x, pos.y))) {
+                const PathTile& tile = (*awareTiles)[(pos.y - awareRect.top()) * awareRect.width() + (pos.x - awareRect.left())];
+                if(tile.flags != 0)
+                    return tile;
+            }
+            return getMinimapPathTile(minimap->getTile(pos));
+        }, std::get<0>(ret), std::get<1>(ret), canceled.get());
+        return ret;
+    });
 
-    return ret;
+    return requestId;
+}
+
+void Map::cancelPathFind(uint32 requestId)
+{
+    const auto it = m_pathFindRequests.find(requestId);
+    if(it == m_pathFindRequests.end())
+        return;
+
+    // the worker stops on its next node, its result is dropped
+    it->second.canceled->store(true);
+    m_pathFindRequests.erase(it);
+}
+
+void Map::cancelAllPathFinds()
+{
+    for(auto& it : m_pathFindRequests)
+        it.second.canceled->store(true);
+    m_pathFindRequests.clear();
+
+    if(m_pathFindEvent) {
+        m_pathFindEvent->cancel();
+        m_pathFindEvent = nullptr;
+    }
+}
+
+void Map::pollPathFinds()
+{
+    // callbacks may request or cancel other searches, so take the finished ones out first
+    std::vector<std::pair<PathFindCallback, PathFindResult>> finished;
+    for(auto it = m_pathFindRequests.begin(); it != m_pathFindRequests.end();) {
+        // requests with nothing to search have no result, they are answered by their own event
+        if(!it->second.result.valid() || !it->second.result.is_ready()) {
+            ++it;
+            continue;
+        }
+
+        finished.emplace_back(it->second.callback, it->second.result.get());
+        it = m_pathFindRequests.erase(it);
+    }
+
+    if(m_pathFindRequests.empty() && m_pathFindEvent) {
+        m_pathFindEvent->cancel();
+        m_pathFindEvent = nullptr;
+    }
+
+    for(const auto& it : finished) {
+        if(it.first)
+            it.first(std::get<0>(it.second), std::get<1>(it.second));
+    }
 }
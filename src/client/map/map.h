@@ -32,6 +32,7 @@
 #include <client/manager/towns.h>
 
 #include <framework/core/clock.h>
+#include <framework/core/asyncdispatcher.h>
 #include <framework/graphics/framebuffer.h>
 
 enum OTBM_ItemAttr
@@ -101,7 +102,12 @@ enum : uint8 {
 
 class TileBlock {
 public:
-    TileBlock() { m_tiles.fill(nullptr); }
+    TileBlock()
+    {
+        m_tiles.fill(nullptr);
+        m_opaqueRows.fill(0);
+        m_topGroundRows.fill(0);
+    }
 
     const TilePtr& create(const Position& pos)
     {
@@ -117,20 +123,203 @@ public:
         return tile;
     }
     const TilePtr& get(const Position& pos) { return m_tiles[getTileIndex(pos)]; }
-    void remove(const Position& pos) { m_tiles[getTileIndex(pos)] = nullptr; }
+    void remove(const Position& pos)
+    {
+        m_tiles[getTileIndex(pos)] = nullptr;
+        setOccluder(pos, false, false);
+    }
 
     uint getTileIndex(const Position& pos) { return ((pos.y % BLOCK_SIZE) * BLOCK_SIZE) + (pos.x % BLOCK_SIZE); }
 
     const std::array<TilePtr, BLOCK_SIZE* BLOCK_SIZE>& getTiles() const { return m_tiles; }
 
+    // occlusion bits of the tiles, one row of the block per word
+    void setOccluder(const Position& pos, bool fullyOpaque, bool topGround)
+    {
+        const uint32 bit = 1u << (pos.x % BLOCK_SIZE);
+        uint32& opaqueRow = m_opaqueRows[pos.y % BLOCK_SIZE];
+        uint32& topGroundRow = m_topGroundRows[pos.y % BLOCK_SIZE];
+        opaqueRow = fullyOpaque ? opaqueRow | bit : opaqueRow & ~bit;
+        topGroundRow = topGround ? topGroundRow | bit : topGroundRow & ~bit;
+    }
+    bool isFullyOpaque(const Position& pos) const { return (m_opaqueRows[pos.y % BLOCK_SIZE] >> (pos.x % BLOCK_SIZE)) & 1; }
+    bool isTopGround(const Position& pos) const { return (m_topGroundRows[pos.y % BLOCK_SIZE] >> (pos.x % BLOCK_SIZE)) & 1; }
+    uint32 getOpaqueRow(uint8 y) const { return m_opaqueRows[y]; }
+    uint32 getTopGroundRow(uint8 y) const { return m_topGroundRows[y]; }
+
 private:
     std::array<TilePtr, BLOCK_SIZE* BLOCK_SIZE> m_tiles;
+    std::array<uint32, BLOCK_SIZE> m_opaqueRows;
+    std::array<uint32, BLOCK_SIZE> m_topGroundRows;
+};
+
+// Tile blocks of one floor indexed by a two level page table, the directory
+// covers the whole floor and its regions are only allocated when a block
+// inside them is created, so a lookup is two array indexes and no hashing.
+class TileStorage {
+public:
+    enum {
+        REGION_BLOCKS = 32,
+        REGION_SIZE = REGION_BLOCKS * BLOCK_SIZE,
+        DIRECTORY_SIZE = 65536 / REGION_SIZE
+    };
+
+    TileBlock* findBlock(const Position& pos)
+    {
+        const uint blockIndex = getBlockIndex(pos);
+        if(blockIndex == m_lastBlockIndex)
+            return m_lastBlock;
+
+        const Region* region = m_regions[blockIndex / (REGION_BLOCKS * REGION_BLOCKS)].get();
+        TileBlock* block = region ? region->blocks[blockIndex % (REGION_BLOCKS * REGION_BLOCKS)].get() : nullptr;
+        m_lastBlockIndex = blockIndex;
+        m_lastBlock = block;
+        return block;
+    }
+
+    TileBlock& getOrCreateBlock(const Position& pos)
+    {
+        if(TileBlock* block = findBlock(pos))
+            return *block;
+
+        const uint blockIndex = getBlockIndex(pos);
+        auto& region = m_regions[blockIndex / (REGION_BLOCKS * REGION_BLOCKS)];
+        if(!region)
+            region.reset(new Region);
+
+        auto& block = region->blocks[blockIndex % (REGION_BLOCKS * REGION_BLOCKS)];
+        block.reset(new TileBlock);
+        ++region->blockCount;
+        ++m_blockCount;
+
+        m_lastBlockIndex = blockIndex;
+        m_lastBlock = block.get();
+        return *block;
+    }
+
+    const TilePtr& get(const Position& pos, const TilePtr& nullTile)
+    {
+        const TileBlock* block = findBlock(pos);
+        return block ? block->getTiles()[((pos.y % BLOCK_SIZE) * BLOCK_SIZE) + (pos.x % BLOCK_SIZE)] : nullTile;
+    }
+
+    bool isFullyOpaque(const Position& pos)
+    {
+        const TileBlock* block = findBlock(pos);
+        return block && block->isFullyOpaque(pos);
+    }
+
+    bool isTopGround(const Position& pos)
+    {
+        const TileBlock* block = findBlock(pos);
+        return block && block->isTopGround(pos);
+    }
+
+    void clear()
+    {
+        for(auto& region : m_regions)
+            region.reset();
+        m_blockCount = 0;
+        invalidateCache();
+    }
+
+    template<typename F>
+    void forEachBlock(F&& f)
+    {
+        for(const auto& region : m_regions) {
+            if(!region)
+                continue;
+
+            for(const auto& block : region->blocks) {
+                if(block)
+                    f(*block);
+            }
+        }
+    }
+
+    // calls pred for every allocated block and releases the ones it returns true for
+    template<typename F>
+    void removeBlocksIf(F&& pred)
+    {
+        for(auto& region : m_regions) {
+            if(!region)
+                continue;
+
+            for(auto& block : region->blocks) {
+                if(!block || !pred(*block))
+                    continue;
+
+                block.reset();
+                --region->blockCount;
+                --m_blockCount;
+            }
+
+            if(region->blockCount == 0)
+                region.reset();
+        }
+        invalidateCache();
+    }
+
+    // calls f for every existing tile inside the rect, walking block by block
+    template<typename F>
+    void forEachTile(int left, int top, int right, int bottom, F&& f)
+    {
+        left = std::max<int>(left, 0);
+        top = std::max<int>(top, 0);
+        right = std::min<int>(right, 65535);
+        bottom = std::min<int>(bottom, 65535);
+
+        for(int by = top - top % BLOCK_SIZE; by <= bottom; by += BLOCK_SIZE) {
+            for(int bx = left - left % BLOCK_SIZE; bx <= right; bx += BLOCK_SIZE) {
+                const TileBlock* block = findBlock(Position(bx, by, 0));
+                if(!block)
+                    continue;
+
+                const auto& tiles = block->getTiles();
+                const int y1 = std::min<int>(bottom, by + BLOCK_SIZE - 1);
+                const int x1 = std::min<int>(right, bx + BLOCK_SIZE - 1);
+                for(int y = std::max<int>(top, by); y <= y1; ++y) {
+                    for(int x = std::max<int>(left, bx); x <= x1; ++x) {
+                        const TilePtr& tile = tiles[((y % BLOCK_SIZE) * BLOCK_SIZE) + (x % BLOCK_SIZE)];
+                        if(tile)
+                            f(tile);
+                    }
+                }
+            }
+        }
+    }
+
+    uint getBlockCount() { return m_blockCount; }
+
+private:
+    struct Region {
+        std::array<std::unique_ptr<TileBlock>, REGION_BLOCKS* REGION_BLOCKS> blocks;
+        uint blockCount{ 0 };
+    };
+
+    // blocks are numbered region by region, so blocks of the same region are contiguous
+    static uint getBlockIndex(const Position& pos)
+    {
+        const uint bx = pos.x / BLOCK_SIZE, by = pos.y / BLOCK_SIZE;
+        const uint region = (by / REGION_BLOCKS) * DIRECTORY_SIZE + (bx / REGION_BLOCKS);
+        return region * (REGION_BLOCKS * REGION_BLOCKS) + (by % REGION_BLOCKS) * REGION_BLOCKS + (bx % REGION_BLOCKS);
+    }
+
+    void invalidateCache() { m_lastBlockIndex = UINT_MAX; m_lastBlock = nullptr; }
+
+    std::array<std::unique_ptr<Region>, DIRECTORY_SIZE* DIRECTORY_SIZE> m_regions;
+    uint m_blockCount{ 0 };
+    uint m_lastBlockIndex{ UINT_MAX };
+    TileBlock* m_lastBlock{ nullptr };
 };
 
 //@bindsingleton g_map
 class Map
 {
 public:
+    using PathFindResult = std::tuple<std::vector<Otc::Direction_t>, Otc::PathFindResult_t>;
+    using PathFindCallback = std::function<void(const std::vector<Otc::Direction_t>&, Otc::PathFindResult_t)>;
+
     void init();
     void terminate();
 
@@ -143,7 +332,9 @@ public:
     bool loadOtcm(const std::string& fileName);
     void saveOtcm(const std::string& fileName);
 
-    void loadOtbm(const std::string& fileName);
+    // tile areas are parsed in parallel, onProgress runs on the main thread and may call cancelOtbmLoad
+    void loadOtbm(const std::string& fileName, const std::function<void(float)>& onProgress = nullptr);
+    void cancelOtbmLoad() { if(m_otbmLoadCanceled) *m_otbmLoadCanceled = true; }
     void saveOtbm(const std::string& fileName);
 
     // otbm attributes (description, size, etc.)
@@ -210,7 +401,13 @@ public:
     std::vector<CreaturePtr> getSightSpectators(const Position& centerPos, bool multiFloor);
     std::vector<CreaturePtr> getSpectators(const Position& centerPos, bool multiFloor);
     std::vector<CreaturePtr> getSpectatorsInRange(const Position& centerPos, bool multiFloor, int32 xRange, int32 yRange);
-    std::vector<CreaturePtr> getSpectatorsInRangeEx(const Position& centerPos, bool multiFloor, int32 minXRange, int32 maxXRange, int32 minYRange, int32 maxYRange);
+    std::vector<CreaturePtr> getSpectatorsInRangeEx(const Position& centerPos, bool multiFloor, int32 minXRange, int32 maxXRange, int32 minYRange, int32 maxYRange, bool orderByDistance = false);
+
+    // visits the same creatures as getSpectatorsInRangeEx without building a vector,
+    // the pointers must not be kept after the visitor returns
+    using SpectatorVisitor = std::function<void(Creature*)>;
+    void forEachSpectatorInRange(const Position& centerPos, bool multiFloor, int32 minXRange, int32 maxXRange, int32 minYRange, int32 maxYRange, const SpectatorVisitor& visitor, bool orderByDistance = false);
+    void updateCreatureTile(const Position& pos, bool hasCreature);
 
     void setLight(const Light& light);
 
@@ -219,6 +416,7 @@ public:
     bool isLookPossible(const Position& pos);
     bool isCovered(const Position& pos, uint8 firstFloor = 0);
     bool isCompletelyCovered(const Position& pos, uint8 firstFloor = 0);
+    void updateOccluder(const Position& pos, bool fullyOpaque, bool topGround);
     bool isAwareOfPosition(const Position& pos);
 
     void setAwareRange(const AwareRange& range);
@@ -234,15 +432,29 @@ public:
     std::vector<AnimatedTextPtr> getAnimatedTexts() { return m_animatedTexts; }
     std::vector<StaticTextPtr> getStaticTexts() { return m_staticTexts; }
 
-    std::tuple<std::vector<Otc::Direction_t>, Otc::PathFindResult_t> findPath(const Position& start, const Position& goal, uint16 maxComplexity, uint32 flags = 0);
+    PathFindResult findPath(const Position& start, const Position& goal, uint16 maxComplexity, uint32 flags = 0);
+    uint32 findPathAsync(const Position& start, const Position& goal, uint16 maxComplexity, uint32 flags, const PathFindCallback& callback);
+    void cancelPathFind(uint32 requestId);
+    void cancelAllPathFinds();
 
     void setFloatingEffect(bool enable) { m_floatingEffect = enable; }
     bool isDrawingFloatingEffects() { return m_floatingEffect; }
 
 private:
-    void removeUnawareThings();
+    enum {
+        // minimap around the start and the goal shared with an async search
+        PATH_SNAPSHOT_MARGIN = 24,
+        PATH_POLL_DELAY = 10
+    };
+
+    struct PathFindRequest {
+        PathFindCallback callback;
+        std::shared_ptr<std::atomic<bool>> canceled;
+        boost::shared_future<PathFindResult> result;
+    };
 
-    uint16 getBlockIndex(const Position& pos) { return ((pos.y / BLOCK_SIZE) * (65536 / BLOCK_SIZE)) + (pos.x / BLOCK_SIZE); }
+    void removeUnawareThings();
+    void pollPathFinds();
 
     std::array<std::vector<MissilePtr>, MAX_Z + 1> m_floorMissiles;
 
@@ -250,12 +462,18 @@ private:
     std::vector<StaticTextPtr> m_staticTexts;
     std::vector<MapViewPtr> m_mapViews;
 
-    std::unordered_map<uint, TileBlock> m_tileBlocks[MAX_Z + 1];
+    TileStorage m_tileBlocks[MAX_Z + 1];
     std::unordered_map<uint32, CreaturePtr> m_knownCreatures;
+    std::array<std::vector<Position>, MAX_Z + 1> m_creatureTiles; // positions of the tiles holding creatures, per floor
     std::unordered_map<Position, std::string, Position::Hasher> m_waypoints;
 
     std::map<uint32, Color> m_zoneColors;
 
+    std::map<uint32, PathFindRequest> m_pathFindRequests;
+    std::shared_ptr<std::atomic<bool>> m_otbmLoadCanceled;
+    ScheduledEventPtr m_pathFindEvent;
+    uint32 m_lastPathFindId{ 0 };
+
     stdext::packed_storage<uint8> m_attribs;
 
     uint8 m_animationFlags;
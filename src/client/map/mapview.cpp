@@ -34,6 +34,7 @@
 
 #include <framework/core/application.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/core/framearena.h>
 #include <framework/core/resourcemanager.h>
 #include <framework/graphics/framebuffermanager.h>
 #include <framework/graphics/graphics.h>
@@ -107,10 +108,50 @@ void MapView::updateVisibleTilesCache()
     if(cachedLastVisibleFloor < cachedFirstVisibleFloor)
         cachedLastVisibleFloor = cachedFirstVisibleFloor;
 
+    // a single step on the same floor only exposes a row and/or column of tiles,
+    // the rest of the cache is still valid and in draw order
+    const int dx = cameraPosition.x - m_lastCameraPosition.x;
+    const int dy = cameraPosition.y - m_lastCameraPosition.y;
+    const bool incremental = !m_mustRebuildVisibleTilesCache && m_lastCameraPosition.z == cameraPosition.z &&
+        std::abs(dx) <= 1 && std::abs(dy) <= 1 &&
+        m_cachedFirstVisibleFloor == cachedFirstVisibleFloor && m_cachedLastVisibleFloor == cachedLastVisibleFloor;
+
     m_lastCameraPosition = cameraPosition;
     m_cachedFirstVisibleFloor = cachedFirstVisibleFloor;
     m_cachedLastVisibleFloor = cachedLastVisibleFloor;
 
+    if(incremental) {
+        if(dx != 0 || dy != 0)
+            shiftVisibleTilesCache(cameraPosition, dx, dy);
+
+        // only the tiles reported by onTileUpdate and the ones they may cover are checked again
+        for(const Position& pos : m_updatedTiles)
+            recacheVisibleTiles(pos, cameraPosition);
+
+        if(m_mustUpdateVisibleCreaturesCache || dx != 0 || dy != 0)
+            updateVisibleCreaturesCache(cameraPosition);
+
+        m_floorMin = m_floorMax = cameraPosition.z;
+        for(int_fast32_t iz = m_cachedLastVisibleFloor; iz >= m_cachedFirstVisibleFloor; --iz) {
+            if(m_cachedVisibleTiles[iz].empty())
+                continue;
+
+            if(iz < m_floorMin)
+                m_floorMin = iz;
+            else if(iz > m_floorMax)
+                m_floorMax = iz;
+        }
+    } else
+        rebuildVisibleTilesCache(cameraPosition);
+
+    m_updatedTiles.clear();
+    m_mustUpdateVisibleCreaturesCache = false;
+    m_mustUpdateVisibleTilesCache = false;
+    m_mustRebuildVisibleTilesCache = false;
+}
+
+void MapView::rebuildVisibleTilesCache(const Position& cameraPosition)
+{
     // clear current visible tiles cache
     do {
         m_cachedVisibleTiles[m_floorMin].clear();
@@ -143,10 +184,8 @@ void MapView::updateVisibleTilesCache()
                         continue;
 
                     if(m_mustUpdateVisibleCreaturesCache) {
-                        const auto& tileCreatures = tile->getCreatures();
-                        if(isInRange(tilePos) && !tileCreatures.empty()) {
-                            m_visibleCreatures.insert(m_visibleCreatures.end(), tileCreatures.rbegin(), tileCreatures.rend());
-                        }
+                        if(isInRange(tilePos))
+                            tile->forEachCreatureFromTop([this](Creature* creature) { m_visibleCreatures.emplace_back(creature); });
                     }
 
                     // skip tiles that are completely behind another tile
@@ -165,9 +204,137 @@ void MapView::updateVisibleTilesCache()
             }
         }
     }
+}
 
-    m_mustUpdateVisibleCreaturesCache = false;
-    m_mustUpdateVisibleTilesCache = false;
+bool MapView::canCacheVisibleTile(const TilePtr& tile)
+{
+    // skip tiles that have nothing
+    if(!tile->isDrawable())
+        return false;
+
+    // skip tiles that are completely behind another tile
+    if(tile->isCompletelyCovered(m_cachedFirstVisibleFloor) && !tile->hasLight())
+        return false;
+
+    return true;
+}
+
+void MapView::shiftVisibleTilesCache(const Position& cameraPosition, const int dx, const int dy)
+{
+    FrameVector<TilePtr> exposedTiles(&g_frameArena);
+    std::vector<TilePtr> mergedTiles;
+    for(int_fast32_t iz = m_cachedLastVisibleFloor; iz >= m_cachedFirstVisibleFloor; --iz) {
+        auto& floor = m_cachedVisibleTiles[iz];
+
+        // drop tiles that left the area, a tile replaced meanwhile is checked again
+        floor.erase(std::remove_if(floor.begin(), floor.end(), [&](const TilePtr& tile) {
+            const Position& pos = tile->getPosition();
+            if(!isInVisibleTilesArea(getVisibleTileCoords(pos, cameraPosition)))
+                return true;
+            if(g_map.getTile(pos) != tile) {
+                m_updatedTiles.push_back(pos);
+                return true;
+            }
+            return false;
+        }), floor.end());
+
+        // collect the newly exposed tiles in draw order, they weren't in the area before the step
+        exposedTiles.clear();
+        const int width = m_drawDimension.width(), height = m_drawDimension.height();
+        for(int diagonal = 0; diagonal < width + height - 1; ++diagonal) {
+            for(int iy = height, ix = diagonal - height; iy >= 0 && ix < width; --iy, ++ix) {
+                if(isInVisibleTilesArea(Point(ix + dx, iy + dy)))
+                    continue;
+
+                Position tilePos = cameraPosition.translated(ix - m_virtualCenterOffset.x, iy - m_virtualCenterOffset.y);
+                tilePos.coveredUp(cameraPosition.z - iz);
+                const TilePtr& tile = g_map.getTile(tilePos);
+                if(!tile || !canCacheVisibleTile(tile))
+                    continue;
+
+                tile->onAddVisibleTileList(this);
+                exposedTiles.push_back(tile);
+            }
+        }
+
+        if(exposedTiles.empty())
+            continue;
+
+        mergedTiles.clear();
+        mergedTiles.reserve(floor.size() + exposedTiles.size());
+        std::merge(floor.begin(), floor.end(), exposedTiles.begin(), exposedTiles.end(), std::back_inserter(mergedTiles), [&](const TilePtr& a, const TilePtr& b) {
+            return isDrawnBefore(getVisibleTileCoords(a->getPosition(), cameraPosition), getVisibleTileCoords(b->getPosition(), cameraPosition));
+        });
+        floor.swap(mergedTiles);
+    }
+}
+
+void MapView::recacheVisibleTiles(const Position& pos, const Position& cameraPosition)
+{
+    // a tile can only hide the tiles below it, see Map::isCovered and Map::isCompletelyCovered
+    static const Point coverOffsets[] = { Point(0, 0), Point(1, 1), Point(-1, 0), Point(0, -1), Point(-1, -1) };
+
+    recacheVisibleTile(pos, cameraPosition);
+    for(int k = 1; pos.z + k <= m_cachedLastVisibleFloor; ++k) {
+        for(const Point& offset : coverOffsets)
+            recacheVisibleTile(pos.translated(-offset.x - k, -offset.y - k, k), cameraPosition);
+    }
+
+    // the border state of the cached neighbours depends on this tile
+    if(pos.z >= m_cachedFirstVisibleFloor && pos.z <= m_cachedLastVisibleFloor) {
+        for(const TilePtr& tile : m_cachedVisibleTiles[pos.z]) {
+            const Position& tilePos = tile->getPosition();
+            if(tilePos != pos && std::abs(tilePos.x - pos.x) <= 1 && std::abs(tilePos.y - pos.y) <= 1)
+                tile->onAddVisibleTileList(this);
+        }
+    }
+}
+
+void MapView::recacheVisibleTile(const Position& pos, const Position& cameraPosition)
+{
+    if(!pos.isMapPosition() || pos.z < m_cachedFirstVisibleFloor || pos.z > m_cachedLastVisibleFloor)
+        return;
+
+    const Point coords = getVisibleTileCoords(pos, cameraPosition);
+    if(!isInVisibleTilesArea(coords))
+        return;
+
+    auto& floor = m_cachedVisibleTiles[pos.z];
+    floor.erase(std::remove_if(floor.begin(), floor.end(), [&](const TilePtr& tile) { return tile->getPosition() == pos; }), floor.end());
+
+    const TilePtr& tile = g_map.getTile(pos);
+    if(!tile || !canCacheVisibleTile(tile))
+        return;
+
+    tile->onAddVisibleTileList(this);
+    const auto it = std::lower_bound(floor.begin(), floor.end(), coords, [&](const TilePtr& other, const Point& value) {
+        return isDrawnBefore(getVisibleTileCoords(other->getPosition(), cameraPosition), value);
+    });
+    floor.insert(it, tile);
+}
+
+void MapView::updateVisibleCreaturesCache(const Position& cameraPosition)
+{
+    m_visibleCreatures.clear();
+
+    const uint32 numDiagonals = m_drawDimension.width() + m_drawDimension.height() - 1;
+    for(int_fast32_t iz = m_cachedLastVisibleFloor; iz >= m_cachedFirstVisibleFloor; --iz) {
+        for(uint_fast32_t diagonal = 0; diagonal < numDiagonals; ++diagonal) {
+            const uint32 advance = std::max<uint32>(diagonal - m_drawDimension.height(), 0);
+            for(int iy = diagonal - advance, ix = advance; iy >= 0 && ix < m_drawDimension.width(); --iy, ++ix) {
+                Position tilePos = cameraPosition.translated(ix - m_virtualCenterOffset.x, iy - m_virtualCenterOffset.y);
+                tilePos.coveredUp(cameraPosition.z - iz);
+                if(!isInRange(tilePos))
+                    continue;
+
+                const TilePtr& tile = g_map.getTile(tilePos);
+                if(!tile || !tile->isDrawable())
+                    continue;
+
+                tile->forEachCreatureFromTop([this](Creature* creature) { m_visibleCreatures.emplace_back(creature); });
+            }
+        }
+    }
 }
 
 void MapView::updateGeometry(const Size& visibleDimension, const Size& optimizedSize)
@@ -267,9 +434,25 @@ void MapView::onFloorDrawingStart(const uint8 /*floor*/) {}
 
 void MapView::onFloorDrawingEnd(const uint8 /*floor*/) {}
 
-void MapView::onTileUpdate(const Position&)
+void MapView::onTileUpdate(const Position& pos)
 {
-    requestVisibleTilesCacheUpdate();
+    m_mustUpdateVisibleTilesCache = true;
+    if(m_mustRebuildVisibleTilesCache)
+        return;
+
+    // tiles away from the view can't change what is drawn, the camera may still step once before the update
+    if(!isInVisibleTilesArea(getVisibleTileCoords(pos, m_lastCameraPosition), 2))
+        return;
+
+    if(std::find(m_updatedTiles.begin(), m_updatedTiles.end(), pos) != m_updatedTiles.end())
+        return;
+
+    if(m_updatedTiles.size() >= MAX_VISIBLE_TILE_UPDATES) {
+        m_mustRebuildVisibleTilesCache = true;
+        return;
+    }
+
+    m_updatedTiles.push_back(pos);
 }
 
 void MapView::onPositionChange(const Position& /*newPos*/, const Position& /*oldPos*/) {}
@@ -302,7 +485,8 @@ void MapView::onKeyRelease(const InputEvent& inputEvent)
 
 void MapView::onMapCenterChange(const Position&)
 {
-    requestVisibleTilesCacheUpdate();
+    // the step itself is handled by updateVisibleTilesCache
+    m_mustUpdateVisibleTilesCache = true;
 }
 
 void MapView::updateLight()
@@ -387,7 +571,7 @@ void MapView::setCameraPosition(const Position& pos)
 {
     m_follow = false;
     m_customCameraPosition = pos;
-    requestVisibleTilesCacheUpdate();
+    m_mustUpdateVisibleTilesCache = true;
 }
 
 Position MapView::getPosition(const Point& point, const Size& mapSize)
@@ -438,7 +622,7 @@ void MapView::move(int32 x, int32 y)
     }
 
     if(requestTilesUpdate) {
-        requestVisibleTilesCacheUpdate();
+        m_mustUpdateVisibleTilesCache = true;
         onCameraMove(m_moveOffset);
     }
 }
@@ -495,15 +679,15 @@ uint8 MapView::calcFirstVisibleFloor()
                             const auto isLookPossible = g_map.isLookPossible(pos);
                             while(coveredPos.coveredUp() && upperPos.up() && upperPos.z >= firstFloor) {
                                 // check tiles physically above
-                                TilePtr tile = g_map.getTile(upperPos);
-                                if(tile && tile->limitsFloorsView(!isLookPossible)) {
+                                const TilePtr& upperTile = g_map.getTile(upperPos);
+                                if(upperTile && upperTile->limitsFloorsView(!isLookPossible)) {
                                     firstFloor = upperPos.z + 1;
                                     break;
                                 }
 
                                 // check tiles geometrically above
-                                tile = g_map.getTile(coveredPos);
-                                if(tile && tile->limitsFloorsView(isLookPossible)) {
+                                const TilePtr& coveredTile = g_map.getTile(coveredPos);
+                                if(coveredTile && coveredTile->limitsFloorsView(isLookPossible)) {
                                     firstFloor = coveredPos.z + 1;
                                     break;
                                 }
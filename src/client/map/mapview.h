@@ -159,6 +159,11 @@ protected:
     friend class MapViewPainter;
 
 private:
+    enum {
+        // above this many tile updates between two frames the cache is rebuilt from scratch
+        MAX_VISIBLE_TILE_UPDATES = 32
+    };
+
     struct FrameCache {
         FrameBufferPtr tile, staticText, dynamicText, creatureInformation;
 
@@ -172,9 +177,30 @@ private:
     };
 
     void updateStaticTextFrame() { m_frameCache.staticText->update(); }
-    void requestVisibleTilesCacheUpdate() { m_mustUpdateVisibleTilesCache = true; }
+    void requestVisibleTilesCacheUpdate() { m_mustUpdateVisibleTilesCache = m_mustRebuildVisibleTilesCache = true; }
     void updateGeometry(const Size& visibleDimension, const Size& optimizedSize);
     void updateVisibleTilesCache();
+    void rebuildVisibleTilesCache(const Position& cameraPosition);
+    void shiftVisibleTilesCache(const Position& cameraPosition, int dx, int dy);
+    void recacheVisibleTiles(const Position& pos, const Position& cameraPosition);
+    void recacheVisibleTile(const Position& pos, const Position& cameraPosition);
+    void updateVisibleCreaturesCache(const Position& cameraPosition);
+    bool canCacheVisibleTile(const TilePtr& tile);
+
+    // position of a tile inside the visible tiles area, the area is walked in diagonals
+    Point getVisibleTileCoords(const Position& pos, const Position& cameraPosition)
+    {
+        const int floorOffset = cameraPosition.z - pos.z;
+        return Point(pos.x - cameraPosition.x + m_virtualCenterOffset.x - floorOffset,
+                     pos.y - cameraPosition.y + m_virtualCenterOffset.y - floorOffset);
+    }
+    bool isInVisibleTilesArea(const Point& coords, const int margin = 0)
+    {
+        const int diagonal = coords.x + coords.y;
+        return coords.y >= -margin && coords.y <= m_drawDimension.height() + margin && coords.x < m_drawDimension.width() + margin &&
+            diagonal >= -2 * margin && diagonal < m_drawDimension.width() + m_drawDimension.height() - 1 + 2 * margin;
+    }
+    static bool isDrawnBefore(const Point& a, const Point& b) { return a.x + a.y < b.x + b.y || (a.x + a.y == b.x + b.y && a.y > b.y); }
 
     uint8 calcFirstVisibleFloor();
     uint8 calcLastVisibleFloor();
@@ -230,6 +256,7 @@ private:
         m_drawHighlightTarget{ false },
         m_shiftPressed{ false },
         m_mustUpdateVisibleTilesCache{ true },
+        m_mustRebuildVisibleTilesCache{ true },
         m_mustUpdateVisibleCreaturesCache{ true },
         m_shaderSwitchDone{ true },
         m_drawHealthBars{ true },
@@ -244,6 +271,7 @@ private:
     std::vector<CreaturePtr> m_visibleCreatures;
 
     std::array<std::vector<TilePtr>, MAX_Z + 1> m_cachedVisibleTiles;
+    std::vector<Position> m_updatedTiles;
 
     PainterShaderProgramPtr m_shader, m_nextShader;
     LightViewPtr m_lightView;
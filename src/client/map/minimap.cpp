@@ -24,6 +24,7 @@
 #include <client/map/tile.h>
 
 #include <zlib.h>
+#include <framework/core/asyncdispatcher.h>
 #include <framework/core/filestream.h>
 #include <framework/core/resourcemanager.h>
 #include <framework/graphics/framebuffermanager.h>
@@ -36,34 +37,172 @@
 
 Minimap g_minimap;
 
+namespace {
+    // lod blocks rebuilt per draw at most, the others keep their old texture until the next frames
+    constexpr int MAX_LOD_UPDATES_PER_DRAW = 16;
+
+    const std::array<uint32, 256>& getMinimapPalette()
+    {
+        static const std::array<uint32, 256> palette = [] {
+            std::array<uint32, 256> colors;
+            for(int c = 0; c < UINT8_MAX; ++c)
+                colors[c] = Color::from8bit(c).rgba();
+            colors[UINT8_MAX] = Color::alpha.rgba();
+            return colors;
+        }();
+        return palette;
+    }
+}
+
+MinimapBlock::TileStorage MinimapBlock::TileStorage::encode(const TileArray& tiles)
+{
+    TileStorage storage;
+    storage.m_palette.clear();
+
+    std::array<uint8, TILE_COUNT> indexes;
+    int entry = -1;
+    for(uint i = 0; i < TILE_COUNT; ++i) {
+        const MinimapTile& tile = tiles[i];
+
+        // neighbour tiles are mostly alike, so the palette is only searched when the tile changes
+        if(entry < 0 || storage.m_palette[entry] != tile) {
+            const auto it = std::find(storage.m_palette.begin(), storage.m_palette.end(), tile);
+            if(it == storage.m_palette.end()) {
+                if(storage.m_palette.size() == 256) {
+                    storage.m_tier = DenseTier;
+                    storage.m_palette.clear();
+                    storage.m_data.resize(sizeof(TileArray));
+                    memcpy(storage.m_data.data(), tiles.data(), sizeof(TileArray));
+                    return storage;
+                }
+                storage.m_palette.push_back(tile);
+                entry = storage.m_palette.size() - 1;
+            } else
+                entry = it - storage.m_palette.begin();
+        }
+        indexes[i] = entry;
+    }
+
+    storage.m_palette.shrink_to_fit();
+    if(storage.m_palette.size() == 1) {
+        storage.m_tier = UniformTier;
+    } else if(storage.m_palette.size() <= 16) {
+        storage.m_tier = Palette4Tier;
+        storage.m_data.resize(TILE_COUNT / 2);
+        for(uint i = 0; i < TILE_COUNT; i += 2)
+            storage.m_data[i / 2] = indexes[i] | indexes[i + 1] << 4;
+    } else {
+        storage.m_tier = Palette8Tier;
+        storage.m_data.assign(indexes.begin(), indexes.end());
+    }
+    return storage;
+}
+
+void MinimapBlock::TileStorage::decode(TileArray& tiles) const
+{
+    switch(m_tier) {
+    case UniformTier:
+        tiles.fill(m_palette[0]);
+        break;
+    case DenseTier:
+        memcpy(tiles.data(), m_data.data(), sizeof(TileArray));
+        break;
+    default:
+        for(uint i = 0; i < TILE_COUNT; ++i)
+            tiles[i] = get(i);
+        break;
+    }
+}
+
+void MinimapBlock::TileStorage::set(uint index, const MinimapTile& tile)
+{
+    if(m_tier == DenseTier) {
+        reinterpret_cast<MinimapTile*>(m_data.data())[index] = tile;
+        return;
+    }
+
+    if(get(index) == tile)
+        return;
+
+    auto it = std::find(m_palette.begin(), m_palette.end(), tile);
+    if(it == m_palette.end()) {
+        const uint capacity = m_tier == UniformTier ? 1 : (m_tier == Palette4Tier ? 16 : 256);
+        if(m_palette.size() >= capacity) {
+            // encoding again drops the unused entries, the tier only grows when the block really needs it
+            TileArray tiles;
+            decode(tiles);
+            tiles[index] = tile;
+            *this = encode(tiles);
+            return;
+        }
+        it = m_palette.insert(m_palette.end(), tile);
+    }
+
+    const uint8 entry = it - m_palette.begin();
+    switch(m_tier) {
+    case Palette4Tier:
+    {
+        uint8& byte = m_data[index / 2];
+        const int shift = (index % 2) * 4;
+        byte = (byte & ~(0xF << shift)) | entry << shift;
+        break;
+    }
+    case Palette8Tier:
+        m_data[index] = entry;
+        break;
+    default:
+        break;
+    }
+}
+
+const MinimapBlock::TileStoragePtr& MinimapBlock::getEmptyTiles()
+{
+    static const TileStoragePtr tiles = std::make_shared<TileStorage>();
+    return tiles;
+}
+
 void MinimapBlock::clean()
 {
-    m_tiles.fill(MinimapTile());
+    m_tiles = getEmptyTiles();
     m_texture.reset();
+    m_dirtyRect = Rect();
     m_mustUpdate = false;
 }
 
 void MinimapBlock::update()
 {
-    if(!m_mustUpdate)
+    if(!m_mustUpdate && !m_dirtyRect.isValid())
         return;
 
-    ImagePtr image(new Image(Size(MMBLOCK_SIZE, MMBLOCK_SIZE)));
-
-    bool shouldDraw = false;
-    for(int x = 0; x < MMBLOCK_SIZE; ++x) {
-        for(int y = 0; y < MMBLOCK_SIZE; ++y) {
-            const uint8 c = getTile(x, y).color;
-            uint32 col;
-            if(c != UINT8_MAX) {
-                col = Color::from8bit(c).rgba();
-                shouldDraw = true;
-            } else
-                col = Color::alpha.rgba();
-            image->setPixel(x, y, col);
+    const auto& palette = getMinimapPalette();
+
+    // converts the tiles of the rect a row at a time into tightly packed pixels
+    const auto convert = [&](const Rect& rect, uint32* pixels) {
+        bool shouldDraw = false;
+        for(int y = rect.top(); y <= rect.bottom(); ++y) {
+            const uint first = getTileIndex(rect.left(), y);
+            uint32* row = pixels + (y - rect.top()) * rect.width();
+            for(int x = 0; x < rect.width(); ++x) {
+                const uint8 color = m_tiles->get(first + x).color;
+                row[x] = palette[color];
+                shouldDraw |= color != UINT8_MAX;
+            }
+        }
+        return shouldDraw;
+    };
+
+    if(!m_mustUpdate && m_texture) {
+        std::array<uint32, MMBLOCK_SIZE* MMBLOCK_SIZE> pixels;
+        convert(m_dirtyRect, pixels.data());
+        if(m_texture->updateRegion(m_dirtyRect, reinterpret_cast<const uint8*>(pixels.data()))) {
+            m_dirtyRect = Rect();
+            return;
         }
     }
 
+    ImagePtr image(new Image(Size(MMBLOCK_SIZE, MMBLOCK_SIZE)));
+    const bool shouldDraw = convert(Rect(0, 0, MMBLOCK_SIZE, MMBLOCK_SIZE), reinterpret_cast<uint32*>(image->getPixelData()));
+
     if(shouldDraw) {
         if(!m_texture) {
             m_texture = TexturePtr(new Texture(image, true));
@@ -73,15 +212,26 @@ void MinimapBlock::update()
     } else
         m_texture.reset();
 
+    m_dirtyRect = Rect();
     m_mustUpdate = false;
 }
 
-void MinimapBlock::updateTile(int x, int y, const MinimapTile& tile)
+bool MinimapBlock::updateTile(int x, int y, const MinimapTile& tile)
 {
-    if(m_tiles[getTileIndex(x, y)].color != tile.color)
-        m_mustUpdate = true;
+    const uint index = getTileIndex(x, y);
+    const MinimapTile& current = m_tiles->get(index);
+    if(current == tile)
+        return false;
 
-    m_tiles[getTileIndex(x, y)] = tile;
+    const bool colorChanged = current.color != tile.color;
+    if(colorChanged) {
+        const Rect tileRect(x % MMBLOCK_SIZE, y % MMBLOCK_SIZE, 1, 1);
+        m_dirtyRect = m_dirtyRect.isValid() ? m_dirtyRect.united(tileRect) : tileRect;
+    }
+
+    detach();
+    m_tiles->set(index, tile);
+    return colorChanged;
 }
 
 void Minimap::init()
@@ -90,13 +240,17 @@ void Minimap::init()
 
 void Minimap::terminate()
 {
+    finishSave();
     clean();
 }
 
 void Minimap::clean()
 {
-    for(int i = 0; i <= MAX_Z; ++i)
+    for(int i = 0; i <= MAX_Z; ++i) {
         m_tileBlocks[i].clear();
+        for(auto& lodBlocks : m_lodBlocks)
+            lodBlocks[i].clear();
+    }
 }
 
 void Minimap::draw(const Rect& screenRect, const Position& mapCenter, float scale, const Color& color)
@@ -111,45 +265,175 @@ void Minimap::draw(const Rect& screenRect, const Position& mapCenter, float scal
     g_painter->resetColor();
     g_painter->setClipRect(screenRect);
 
-    if(MMBLOCK_SIZE * scale <= 1 || !mapCenter.isMapPosition()) {
+    // the coarsest lod block must still cover a pixel
+    if((MMBLOCK_SIZE << (2 * MMLOD_LEVELS)) * scale <= 1 || !mapCenter.isMapPosition()) {
         g_painter->restoreSavedState();
         return;
     }
 
-    const Point blockOff = getBlockOffset(mapRect.topLeft());
+    const int level = getLodLevel(scale);
+    const int blockSize = MMBLOCK_SIZE << (2 * level);
+    int budget = MAX_LOD_UPDATES_PER_DRAW;
+
+    const Point blockOff = Point(mapRect.left() - mapRect.left() % blockSize, mapRect.top() - mapRect.top() % blockSize);
     const Point off = Point((mapRect.size() * scale).toPoint() - screenRect.size().toPoint()) / 2;
     const Point start = screenRect.topLeft() - (mapRect.topLeft() - blockOff) * scale - off;
 
-    for(int y = blockOff.y, ys = start.y; ys < screenRect.bottom(); y += MMBLOCK_SIZE, ys += MMBLOCK_SIZE * scale) {
+    for(int y = blockOff.y, ys = start.y; ys < screenRect.bottom(); y += blockSize, ys += blockSize * scale) {
         if(y < 0 || y >= 65536)
             continue;
 
-        for(int x = blockOff.x, xs = start.x; xs < screenRect.right(); x += MMBLOCK_SIZE, xs += MMBLOCK_SIZE * scale) {
+        for(int x = blockOff.x, xs = start.x; xs < screenRect.right(); x += blockSize, xs += blockSize * scale) {
             if(x < 0 || x >= 65536)
                 continue;
 
-            Position blockPos(x, y, mapCenter.z);
-            if(!hasBlock(blockPos))
-                continue;
+            const Position blockPos(x, y, mapCenter.z);
+            TexturePtr tex;
+            if(level == 0) {
+                if(!hasBlock(blockPos))
+                    continue;
 
-            MinimapBlock& block = getBlock(Position(x, y, mapCenter.z));
-            block.update();
+                MinimapBlock& block = getBlock(blockPos);
+                block.update();
+                tex = block.getTexture();
+            } else {
+                const uint index = getLodIndex(blockPos, level);
+                const auto it = m_lodBlocks[level - 1][mapCenter.z].find(index);
+                if(it == m_lodBlocks[level - 1][mapCenter.z].end())
+                    continue;
+
+                updateLod(level, mapCenter.z, index, budget);
+                tex = it->second.texture;
+            }
 
-            const TexturePtr& tex = block.getTexture();
             if(tex) {
                 Rect src(0, 0, MMBLOCK_SIZE, MMBLOCK_SIZE);
-                Rect dest(Point(xs, ys), src.size() * scale);
+                Rect dest(Point(xs, ys), Size(blockSize * scale, blockSize * scale));
 
-                tex->setSmooth(scale < 1.0f);
+                tex->setSmooth(scale * (1 << (2 * level)) < 1.0f);
                 g_painter->drawTexturedRect(dest, tex, src);
             }
-            //g_painter->drawBoundingRect(Rect(xs,ys, MMBLOCK_SIZE * scale, MMBLOCK_SIZE * scale));
+            //g_painter->drawBoundingRect(Rect(xs,ys, blockSize * scale, blockSize * scale));
         }
     }
 
     g_painter->restoreSavedState();
 }
 
+int Minimap::getLodLevel(float scale)
+{
+    // the coarsest level that still has a texel for every screen pixel
+    int level = 0;
+    while(level < MMLOD_LEVELS && (1 << (2 * (level + 1))) * scale <= 1.0f)
+        ++level;
+    return level;
+}
+
+void Minimap::invalidateLods(const Position& pos)
+{
+    for(int level = 1; level <= MMLOD_LEVELS; ++level)
+        m_lodBlocks[level - 1][pos.z][getLodIndex(pos, level)].mustUpdate = true;
+}
+
+bool Minimap::updateLod(int level, int z, uint index, int& budget)
+{
+    MinimapLodBlock& lod = m_lodBlocks[level - 1][z][index];
+    if(!lod.mustUpdate)
+        return true;
+
+    const uint width = 65536 / (MMBLOCK_SIZE << (2 * level));
+    const uint childWidth = width * 4;
+    const uint firstChild = (index / width) * 4 * childWidth + (index % width) * 4;
+
+    // the children are rebuilt first, the block waits for all of them
+    bool ready = true;
+    if(level > 1) {
+        const auto& children = m_lodBlocks[level - 2][z];
+        for(uint j = 0; j < 4; ++j) {
+            for(uint i = 0; i < 4; ++i) {
+                const uint child = firstChild + j * childWidth + i;
+                if(children.find(child) != children.end() && !updateLod(level - 1, z, child, budget))
+                    ready = false;
+            }
+        }
+    }
+
+    if(!ready || budget <= 0)
+        return false;
+    --budget;
+
+    if(!lod.image)
+        lod.image = ImagePtr(new Image(Size(MMBLOCK_SIZE, MMBLOCK_SIZE)));
+
+    // every child fills a quarter of the block side, each pixel averages the 4x4 seen pixels under it
+    bool shouldDraw = false;
+    const auto downsample = [&](uint i, uint j, const auto& getPixel) {
+        constexpr int CHILD_SIZE = MMBLOCK_SIZE / 4;
+        for(int y = 0; y < CHILD_SIZE; ++y) {
+            for(int x = 0; x < CHILD_SIZE; ++x) {
+                uint sum[4] = { 0, 0, 0, 0 };
+                uint count = 0;
+                for(int sy = 0; sy < 4; ++sy) {
+                    for(int sx = 0; sx < 4; ++sx) {
+                        const uint32 pixel = getPixel(x * 4 + sx, y * 4 + sy);
+                        if(pixel == 0)
+                            continue;
+
+                        const auto* channels = reinterpret_cast<const uint8*>(&pixel);
+                        for(int c = 0; c < 4; ++c)
+                            sum[c] += channels[c];
+                        ++count;
+                    }
+                }
+
+                uint8 result[4] = { 0, 0, 0, 0 };
+                if(count > 0) {
+                    for(int c = 0; c < 4; ++c)
+                        result[c] = sum[c] / count;
+                    shouldDraw = true;
+                }
+                lod.image->setPixel(i * CHILD_SIZE + x, j * CHILD_SIZE + y, result);
+            }
+        }
+    };
+
+    for(uint j = 0; j < 4; ++j) {
+        for(uint i = 0; i < 4; ++i) {
+            const uint child = firstChild + j * childWidth + i;
+            if(level == 1) {
+                const auto it = m_tileBlocks[z].find(child);
+                if(it != m_tileBlocks[z].end()) {
+                    const auto& palette = getMinimapPalette();
+                    const MinimapBlock& block = it->second;
+                    downsample(i, j, [&](int x, int y) { return palette[block.getTile(x, y).color]; });
+                    continue;
+                }
+            } else {
+                const auto it = m_lodBlocks[level - 2][z].find(child);
+                if(it != m_lodBlocks[level - 2][z].end() && it->second.image) {
+                    const ImagePtr& image = it->second.image;
+                    downsample(i, j, [&](int x, int y) { uint32 pixel; memcpy(&pixel, image->getPixel(x, y), 4); return pixel; });
+                    continue;
+                }
+            }
+
+            downsample(i, j, [](int, int) { return 0u; });
+        }
+    }
+
+    if(shouldDraw) {
+        if(!lod.texture) {
+            lod.texture = TexturePtr(new Texture(lod.image, true));
+        } else {
+            lod.texture->uploadPixels(lod.image, true);
+        }
+    } else
+        lod.texture.reset();
+
+    lod.mustUpdate = false;
+    return true;
+}
+
 Point Minimap::getTilePoint(const Position& pos, const Rect& screenRect, const Position& mapCenter, float scale)
 {
     if(screenRect.isEmpty() || pos.z != mapCenter.z)
@@ -207,7 +491,8 @@ void Minimap::updateTile(const Position& pos, const TilePtr& tile)
     if(minimapTile != MinimapTile()) {
         MinimapBlock& block = getBlock(pos);
         const Point offsetPos = getBlockOffset(Point(pos.x, pos.y));
-        block.updateTile(pos.x - offsetPos.x, pos.y - offsetPos.y, minimapTile);
+        if(block.updateTile(pos.x - offsetPos.x, pos.y - offsetPos.y, minimapTile))
+            invalidateLods(pos);
         block.justSaw();
     }
 }
@@ -223,6 +508,56 @@ const MinimapTile& Minimap::getTile(const Position& pos)
     return nulltile;
 }
 
+const MinimapTile& MinimapSnapshot::getTile(const Position& pos) const
+{
+    static const MinimapTile nulltile;
+
+    const uint index = ((pos.y / MMBLOCK_SIZE) * (65536 / MMBLOCK_SIZE)) + (pos.x / MMBLOCK_SIZE);
+    const auto it = m_blocks.find(index);
+    if(it == m_blocks.end())
+        return nulltile;
+    return it->second->get(MinimapBlock::getTileIndex(pos.x, pos.y));
+}
+
+MinimapSnapshot Minimap::snapshot(const Rect& rect, int z)
+{
+    MinimapSnapshot snapshot;
+    if(z < 0 || z > MAX_Z || !rect.isValid())
+        return snapshot;
+
+    const int left = std::max<int>(rect.left(), 0) / MMBLOCK_SIZE, right = std::min<int>(rect.right(), 65535) / MMBLOCK_SIZE;
+    const int top = std::max<int>(rect.top(), 0) / MMBLOCK_SIZE, bottom = std::min<int>(rect.bottom(), 65535) / MMBLOCK_SIZE;
+    const auto& blocks = m_tileBlocks[z];
+
+    // walks whichever is smaller, the blocks of the rect or the blocks of the floor
+    if(static_cast<size_t>(right - left + 1) * (bottom - top + 1) > blocks.size()) {
+        for(const auto& it : blocks) {
+            const int x = it.first % (65536 / MMBLOCK_SIZE), y = it.first / (65536 / MMBLOCK_SIZE);
+            if(x >= left && x <= right && y >= top && y <= bottom)
+                snapshot.m_blocks.emplace(it.first, it.second.snapshot());
+        }
+    } else {
+        for(int y = top; y <= bottom; ++y) {
+            for(int x = left; x <= right; ++x) {
+                const auto it = blocks.find(y * (65536 / MMBLOCK_SIZE) + x);
+                if(it != blocks.end())
+                    snapshot.m_blocks.emplace(it->first, it->second.snapshot());
+            }
+        }
+    }
+    return snapshot;
+}
+
+uint Minimap::getMemoryUsage()
+{
+    uint usage = 0;
+    for(const auto& blocks : m_tileBlocks) {
+        for(const auto& it : blocks)
+            usage += it.second.getMemoryUsage();
+    }
+    return usage;
+}
+
 bool Minimap::loadImage(const std::string& fileName, const Position& topLeft, float colorFactor)
 {
     if(colorFactor <= 0.01f)
@@ -284,11 +619,13 @@ bool Minimap::loadImage(const std::string& fileName, const Position& topLeft, fl
                 Position pos(topLeft.x + x, topLeft.y + y, topLeft.z);
                 MinimapBlock& block = getBlock(pos);
                 const Point offsetPos = getBlockOffset(Point(pos.x, pos.y));
-                MinimapTile& tile = block.getTile(pos.x - offsetPos.x, pos.y - offsetPos.y);
+                MinimapTile tile = block.getTile(pos.x - offsetPos.x, pos.y - offsetPos.y);
                 if(!(tile.flags & MinimapTileWasSeen)) {
                     tile.color = c;
                     tile.flags = flags;
+                    block.updateTile(pos.x - offsetPos.x, pos.y - offsetPos.y, tile);
                     block.mustUpdate();
+                    invalidateLods(pos);
                 }
             }
         }
@@ -306,7 +643,12 @@ void Minimap::saveImage(const std::string&, const Rect&)
 
 bool Minimap::loadOtmm(const std::string& fileName)
 {
+    // a pending save may still have to write the file that is about to be read
+    finishSave();
+
     try {
+        stdext::timer loadTimer;
+
         FileStreamPtr fin = g_resources.openFile(fileName);
         if(!fin)
             stdext::throw_exception("unable to open file");
@@ -333,11 +675,21 @@ bool Minimap::loadOtmm(const std::string& fileName)
 
         fin->seek(start);
 
-        const uint blockSize = MMBLOCK_SIZE * MMBLOCK_SIZE * sizeof(MinimapTile);
-        std::vector<uchar> compressBuffer(compressBound(blockSize));
-        std::vector<uchar> decompressBuffer(blockSize);
+        struct OtmmBlock
+        {
+            Position pos;
+            uint offset;
+            uint len;
+            MinimapBlock::TileStoragePtr tiles;
+        };
 
+        // the block headers are walked first, so the blocks can be inflated apart
+        std::vector<OtmmBlock> blocks;
         while(true) {
+            // truncated file, keep the blocks read so far
+            if(fin->tell() + 7 > fin->size())
+                break;
+
             Position pos;
             pos.x = fin->getU16();
             pos.y = fin->getU16();
@@ -347,19 +699,42 @@ bool Minimap::loadOtmm(const std::string& fileName)
             if(!pos.isValid() || pos.z >= MAX_Z + 1)
                 break;
 
-            MinimapBlock& block = getBlock(pos);
-            const ulong len = fin->getU16();
-            ulong destLen = blockSize;
-            fin->read(compressBuffer.data(), len);
-            const int ret = uncompress(decompressBuffer.data(), &destLen, compressBuffer.data(), len);
-            if(ret != Z_OK || destLen != blockSize)
+            const uint len = fin->getU16();
+            if(fin->tell() + len > fin->size())
+                break;
+
+            blocks.push_back({ pos, fin->tell(), len, nullptr });
+            fin->skip(len);
+        }
+
+        const uint8* data = fin->cachedData();
+        g_asyncDispatcher.parallelFor(0, blocks.size(), [&](int begin, int end) {
+            MinimapBlock::TileArray tiles;
+            for(int i = begin; i < end; ++i) {
+                OtmmBlock& block = blocks[i];
+                ulong destLen = sizeof(MinimapBlock::TileArray);
+                const int ret = uncompress(reinterpret_cast<uchar*>(tiles.data()), &destLen, data + block.offset, block.len);
+                if(ret == Z_OK && destLen == sizeof(MinimapBlock::TileArray))
+                    block.tiles = std::make_shared<MinimapBlock::TileStorage>(MinimapBlock::TileStorage::encode(tiles));
+            }
+        }, 64);
+
+        for(OtmmBlock& it : blocks) {
+            // file is corrupted, keep what was read before it
+            if(!it.tiles)
                 break;
 
-            memcpy(&block.getTiles(), decompressBuffer.data(), blockSize);
+            MinimapBlock& block = getBlock(it.pos);
+            block.setTiles(std::move(it.tiles));
             block.mustUpdate();
+            invalidateLods(it.pos);
             block.justSaw();
         }
 
+        const float mb = fin->size() / (1024.f * 1024.f);
+        const int elapsed = loadTimer.elapsed_millis();
+        g_logger.debug(stdext::format("loaded OTMM minimap %s: %d blocks, %.2f MB in %d ms (%.1f ms/MB)", fileName, static_cast<int>(blocks.size()), mb, elapsed, elapsed / std::max<float>(mb, 0.001f)));
+
         fin->close();
         return true;
     } catch(stdext::exception& e) {
@@ -368,12 +743,74 @@ bool Minimap::loadOtmm(const std::string& fileName)
     }
 }
 
+struct Minimap::OtmmSave
+{
+    std::string fileName;
+    std::vector<std::pair<Position, std::shared_ptr<const MinimapBlock::TileStorage>>> blocks;
+    std::vector<std::string> compressed;
+    AsyncTaskGroupPtr group;
+    stdext::timer timer;
+};
+
 void Minimap::saveOtmm(const std::string& fileName)
 {
-    try {
-        stdext::timer saveTimer;
+    // a newer snapshot must not be overwritten by an older one
+    finishSave();
+
+    const OtmmSavePtr save = std::make_shared<OtmmSave>();
+    save->fileName = fileName;
+    for(uint8_t z = 0; z <= MAX_Z; ++z) {
+        for(auto& it : m_tileBlocks[z]) {
+            MinimapBlock& block = it.second;
+            if(block.wasSeen())
+                save->blocks.emplace_back(getIndexPosition(it.first, z), block.snapshot());
+        }
+    }
+    save->compressed.resize(save->blocks.size());
+
+    // compressing runs on the workers, the file is written on the main thread once it is done
+    save->group = g_asyncDispatcher.createTaskGroup();
+    const int count = save->blocks.size();
+    const int step = std::max<int>(64, count / ((g_asyncDispatcher.getThreadCount() + 1) * 4) + 1);
+    for(int begin = 0; begin < count; begin += step) {
+        const int end = std::min<int>(begin + step, count);
+        save->group->run([save, begin, end] {
+            const uint blockSize = sizeof(MinimapBlock::TileArray);
+            const int COMPRESS_LEVEL = 3;
+
+            MinimapBlock::TileArray tiles;
+            for(int i = begin; i < end; ++i) {
+                save->blocks[i].second->decode(tiles);
+
+                std::string& buffer = save->compressed[i];
+                buffer.resize(compressBound(blockSize));
+
+                ulong len = buffer.size();
+                const int ret = compress2(reinterpret_cast<uchar*>(&buffer[0]), &len, reinterpret_cast<const uchar*>(tiles.data()), blockSize, COMPRESS_LEVEL);
+                assert(ret == Z_OK);
+                buffer.resize(len);
+            }
+        });
+    }
+    save->group->then([this, save] {
+        if(m_pendingSave == save)
+            finishSave();
+    });
 
-        FileStreamPtr fin = g_resources.createFile(fileName);
+    m_pendingSave = save;
+}
+
+void Minimap::finishSave()
+{
+    if(!m_pendingSave)
+        return;
+
+    const OtmmSavePtr save = std::move(m_pendingSave);
+    m_pendingSave = nullptr;
+    save->group->wait();
+
+    try {
+        FileStreamPtr fin = g_resources.createFile(save->fileName);
         fin->cache();
 
         //TODO: compression flag with zlib
@@ -394,28 +831,15 @@ void Minimap::saveOtmm(const std::string& fileName)
         fin->addU16(start);
         fin->seek(start);
 
-        const uint blockSize = MMBLOCK_SIZE * MMBLOCK_SIZE * sizeof(MinimapTile);
-        std::vector<uchar> compressBuffer(compressBound(blockSize));
-        const int COMPRESS_LEVEL = 3;
+        for(uint i = 0; i < save->blocks.size(); ++i) {
+            const Position& pos = save->blocks[i].first;
+            fin->addU16(pos.x);
+            fin->addU16(pos.y);
+            fin->addU8(pos.z);
 
-        for(uint8_t z = 0; z <= MAX_Z; ++z) {
-            for(auto& it : m_tileBlocks[z]) {
-                const int index = it.first;
-                MinimapBlock& block = it.second;
-                if(!block.wasSeen())
-                    continue;
-
-                const Position pos = getIndexPosition(index, z);
-                fin->addU16(pos.x);
-                fin->addU16(pos.y);
-                fin->addU8(pos.z);
-
-                ulong len = blockSize;
-                const int ret = compress2(compressBuffer.data(), &len, (uchar*)&block.getTiles(), blockSize, COMPRESS_LEVEL);
-                assert(ret == Z_OK);
-                fin->addU16(len);
-                fin->write(compressBuffer.data(), len);
-            }
+            const std::string& buffer = save->compressed[i];
+            fin->addU16(buffer.size());
+            fin->write(buffer.data(), buffer.size());
         }
 
         // end of file
@@ -424,9 +848,13 @@ void Minimap::saveOtmm(const std::string& fileName)
         fin->addU16(invalidPos.y);
         fin->addU8(invalidPos.z);
 
-        fin->flush();
+        const float mb = fin->size() / (1024.f * 1024.f);
 
+        fin->flush();
         fin->close();
+
+        const int elapsed = save->timer.elapsed_millis();
+        g_logger.debug(stdext::format("saved OTMM minimap %s: %d blocks, %.2f MB in %d ms (%.1f ms/MB)", save->fileName, static_cast<int>(save->blocks.size()), mb, elapsed, elapsed / std::max<float>(mb, 0.001f)));
     } catch(stdext::exception& e) {
         g_logger.error(stdext::format("failed to save OTMM minimap: %s", e.what()));
     }
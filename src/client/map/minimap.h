@@ -28,6 +28,7 @@
 
 enum {
     MMBLOCK_SIZE = 64,
+    MMLOD_LEVELS = 3, // blocks of 256, 1024 and 4096 tiles drawn when zoomed out
     OTMM_SIGNATURE = 0x4D4d544F,
     OTMM_VERSION = 1
 };
@@ -51,28 +52,106 @@ struct MinimapTile
     bool operator!=(const MinimapTile& other) const { return !(*this == other); }
 };
 
+#pragma pack(pop)
+
 class MinimapBlock
 {
 public:
+    enum {
+        TILE_COUNT = MMBLOCK_SIZE * MMBLOCK_SIZE
+    };
+
+    using TileArray = std::array<MinimapTile, TILE_COUNT>;
+
+    // tiles kept in the smallest tier that fits them, most blocks hold only a few distinct tiles
+    class TileStorage
+    {
+    public:
+        enum Tier : uint8 {
+            UniformTier, // a single tile for the whole block
+            Palette4Tier, // up to 16 distinct tiles, 4 bit palette indexes
+            Palette8Tier, // up to 256 distinct tiles, 8 bit palette indexes
+            DenseTier // the tiles themselves
+        };
+
+        static TileStorage encode(const TileArray& tiles);
+        void decode(TileArray& tiles) const;
+
+        const MinimapTile& get(uint index) const
+        {
+            switch(m_tier) {
+            case UniformTier:
+                return m_palette[0];
+            case Palette4Tier:
+                return m_palette[(m_data[index / 2] >> ((index % 2) * 4)) & 0xF];
+            case Palette8Tier:
+                return m_palette[m_data[index]];
+            default:
+                return reinterpret_cast<const MinimapTile*>(m_data.data())[index];
+            }
+        }
+        // promotes the storage when the tile doesn't fit the current tier
+        void set(uint index, const MinimapTile& tile);
+
+        Tier getTier() const { return m_tier; }
+        uint getMemoryUsage() const { return sizeof(TileStorage) + m_palette.capacity() * sizeof(MinimapTile) + m_data.capacity(); }
+
+    private:
+        Tier m_tier{ UniformTier };
+        std::vector<MinimapTile> m_palette{ MinimapTile() };
+        std::vector<uint8> m_data;
+    };
+    using TileStoragePtr = std::shared_ptr<TileStorage>;
+
     void clean();
     void update();
-    void updateTile(int x, int y, const MinimapTile& tile);
-    MinimapTile& getTile(int x, int y) { return m_tiles[getTileIndex(x, y)]; }
-    void resetTile(int x, int y) { m_tiles[getTileIndex(x, y)] = MinimapTile(); }
-    uint getTileIndex(int x, int y) { return ((y % MMBLOCK_SIZE) * MMBLOCK_SIZE) + (x % MMBLOCK_SIZE); }
+    // returns whether the block must be redrawn
+    bool updateTile(int x, int y, const MinimapTile& tile);
+    const MinimapTile& getTile(int x, int y) const { return m_tiles->get(getTileIndex(x, y)); }
+    void resetTile(int x, int y) { detach(); m_tiles->set(getTileIndex(x, y), MinimapTile()); }
+    static uint getTileIndex(int x, int y) { return ((y % MMBLOCK_SIZE) * MMBLOCK_SIZE) + (x % MMBLOCK_SIZE); }
     const TexturePtr& getTexture() { return m_texture; }
-    std::array<MinimapTile, MMBLOCK_SIZE* MMBLOCK_SIZE>& getTiles() { return m_tiles; }
+    void setTiles(TileStoragePtr tiles) { m_tiles = std::move(tiles); }
+    // shares the tiles until the block is written again, for reading them on another thread
+    std::shared_ptr<const TileStorage> snapshot() const { return m_tiles; }
+    uint getMemoryUsage() const { return sizeof(MinimapBlock) + (m_tiles.use_count() == 1 ? m_tiles->getMemoryUsage() : 0); }
     void mustUpdate() { m_mustUpdate = true; }
     void justSaw() { m_wasSeen = true; }
     bool wasSeen() { return m_wasSeen; }
 private:
+    // copy on write, snapshots may still be reading the tiles
+    void detach() { if(m_tiles.use_count() > 1) m_tiles = std::make_shared<TileStorage>(*m_tiles); }
+
+    // unseen tiles shared by every new block
+    static const TileStoragePtr& getEmptyTiles();
+
     TexturePtr m_texture;
-    std::array<MinimapTile, MMBLOCK_SIZE* MMBLOCK_SIZE> m_tiles;
+    TileStoragePtr m_tiles{ getEmptyTiles() };
+    // tiles changed since the last upload, uploaded alone while the texture exists
+    Rect m_dirtyRect;
     bool m_mustUpdate{ true };
     bool m_wasSeen{ false };
 };
 
-#pragma pack(pop)
+// tiles of the blocks of a floor area, shared with the minimap until it writes them, can be read on any thread
+class MinimapSnapshot
+{
+public:
+    const MinimapTile& getTile(const Position& pos) const;
+
+private:
+    std::unordered_map<uint, std::shared_ptr<const MinimapBlock::TileStorage>> m_blocks;
+
+    friend class Minimap;
+};
+
+// downsampled image of 4x4 blocks of the level below, level 1 is made of minimap blocks
+struct MinimapLodBlock
+{
+    ImagePtr image;
+    TexturePtr texture;
+    bool mustUpdate{ true };
+};
 
 class Minimap
 {
@@ -95,7 +174,18 @@ public:
     bool loadOtmm(const std::string& fileName);
     void saveOtmm(const std::string& fileName);
 
+    uint getMemoryUsage();
+
+    // shares the blocks of floor z that overlap the rect
+    MinimapSnapshot snapshot(const Rect& rect, int z);
+
 private:
+    struct OtmmSave;
+    using OtmmSavePtr = std::shared_ptr<OtmmSave>;
+
+    // waits for the pending save to be compressed and writes it
+    void finishSave();
+
     Rect calcMapRect(const Rect& screenRect, const Position& mapCenter, float scale);
     bool hasBlock(const Position& pos) { return m_tileBlocks[pos.z].find(getBlockIndex(pos)) != m_tileBlocks[pos.z].end(); }
     MinimapBlock& getBlock(const Position& pos) { return m_tileBlocks[pos.z][getBlockIndex(pos)]; }
@@ -110,7 +200,18 @@ private:
                         (index / (65536 / MMBLOCK_SIZE)) * MMBLOCK_SIZE, z);
     }
     uint getBlockIndex(const Position& pos) { return ((pos.y / MMBLOCK_SIZE) * (65536 / MMBLOCK_SIZE)) + (pos.x / MMBLOCK_SIZE); }
+    uint getLodIndex(const Position& pos, int level)
+    {
+        const int size = MMBLOCK_SIZE << (2 * level);
+        return ((pos.y / size) * (65536 / size)) + (pos.x / size);
+    }
+    int getLodLevel(float scale);
+    void invalidateLods(const Position& pos);
+    // rebuilds the lod block and its children while the budget lasts, returns whether it is up to date
+    bool updateLod(int level, int z, uint index, int& budget);
     std::unordered_map<uint, MinimapBlock> m_tileBlocks[MAX_Z + 1];
+    std::unordered_map<uint, MinimapLodBlock> m_lodBlocks[MMLOD_LEVELS][MAX_Z + 1];
+    OtmmSavePtr m_pendingSave;
 };
 
 extern Minimap g_minimap;
@@ -100,6 +100,10 @@ void Tile::addThing(const ThingPtr& thing, int stackPos)
 
         thing->setPosition(m_position);
         thing->onAppear();
+
+        // the first effect makes an empty tile drawable
+        if(m_effects.size() == 1 && isEmpty() && m_walkingCreatures.empty())
+            g_map.notificateTileUpdate(m_position);
         return;
     }
 
@@ -166,6 +170,8 @@ bool Tile::removeThing(const ThingPtr thing)
         updateFlag(thing, false);
 
         m_effects.erase(it);
+        if(!isDrawable())
+            g_map.notificateTileUpdate(m_position);
         return true;
     }
 
@@ -290,7 +296,7 @@ ThingPtr Tile::getTopLookThing()
     if(isEmpty())
         return nullptr;
 
-    for(auto thing : m_things) {
+    for(const ThingPtr& thing : m_things) {
         if(!thing->isIgnoreLook() && (!thing->isGround() && !thing->isGroundBorder() && !thing->isOnBottom() && !thing->isOnTop()))
             return thing;
     }
@@ -303,12 +309,12 @@ ThingPtr Tile::getTopUseThing()
     if(isEmpty())
         return nullptr;
 
-    for(auto thing : m_things) {
+    for(const ThingPtr& thing : m_things) {
         if(thing->isForceUse() || (!thing->isGround() && !thing->isGroundBorder() && !thing->isOnBottom() && !thing->isOnTop() && !thing->isCreature() && !thing->isSplash()))
             return thing;
     }
 
-    for(auto thing : m_things) {
+    for(const ThingPtr& thing : m_things) {
         if(!thing->isGround() && !thing->isGroundBorder() && !thing->isCreature() && !thing->isSplash())
             return thing;
     }
@@ -340,11 +346,14 @@ CreaturePtr Tile::getTopCreature(const bool checkAround)
             const TilePtr& tile = g_map.getTile(position);
             if(!tile) continue;
 
-            for(const CreaturePtr& c : tile->getCreatures()) {
-                if(c->isWalking() && c->getLastStepFromPosition() == m_position && c->getStepProgress() < .75f) {
-                    return c;
-                }
-            }
+            Creature* walking = nullptr;
+            tile->forEachCreature([&](Creature* c) {
+                if(!walking && c->isWalking() && c->getLastStepFromPosition() == m_position && c->getStepProgress() < .75f)
+                    walking = c;
+            });
+
+            if(walking)
+                return walking;
         }
     }
 
@@ -523,8 +532,11 @@ void Tile::updateFlag(const ThingPtr& thing, bool add)
     if(thing->isOnTop())
         m_countFlag.hasTopItem += value;
 
-    if(thing->isCreature())
+    if(thing->isCreature()) {
         m_countFlag.hasCreature += value;
+        if(m_countFlag.hasCreature == (add ? 1 : 0))
+            g_map.updateCreatureTile(m_position, add);
+    }
 
     if(thing->isGroundOrBorder())
         m_countFlag.hasGroundOrBorder += value;
@@ -562,6 +574,8 @@ void Tile::updateFlag(const ThingPtr& thing, bool add)
 
     if(!thing->isItem()) return;
 
+    const bool wasFullyOpaque = isFullyOpaque(), wasTopGround = isTopGround();
+
     if(thing->isNotWalkable())
         m_countFlag.notWalkable += value;
 
@@ -587,6 +601,9 @@ void Tile::updateFlag(const ThingPtr& thing, bool add)
 
     if(thing->isGroundBorder() && thing->isNotWalkable())
         m_countFlag.hasNoWalkableEdge += value;
+
+    if(isFullyOpaque() != wasFullyOpaque || isTopGround() != wasTopGround)
+        g_map.updateOccluder(m_position, isFullyOpaque(), isTopGround());
 }
 
 void Tile::select(const bool noFilter)
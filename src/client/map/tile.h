@@ -87,6 +87,34 @@ public:
     const std::vector<CreaturePtr> getCreatures();
     const std::vector<CreaturePtr>& getWalkingCreatures() { return m_walkingCreatures; }
 
+    // hot paths visit creatures in place instead of copying them out with getCreatures(),
+    // the pointers are only valid during the call and the tile must not change meanwhile
+    // (C only defers the cast, creature.h includes this header before Creature is complete)
+    template<typename F, typename C = Creature>
+    void forEachCreature(F&& f) const
+    {
+        if(!m_countFlag.hasCreature)
+            return;
+
+        for(const ThingPtr& thing : m_things) {
+            if(thing->isCreature())
+                f(static_cast<C*>(thing.get()));
+        }
+    }
+
+    // same as forEachCreature but from the top of the stack, the order creatures are drawn in
+    template<typename F, typename C = Creature>
+    void forEachCreatureFromTop(F&& f) const
+    {
+        if(!m_countFlag.hasCreature)
+            return;
+
+        for(auto it = m_things.rbegin(); it != m_things.rend(); ++it) {
+            if((*it)->isCreature())
+                f(static_cast<C*>(it->get()));
+        }
+    }
+
     const std::array<Position, 8> getPositionsAround() { return m_positionsAround; }
 
     ItemPtr getGround();
@@ -27,7 +27,9 @@
 #include <client/map/map.h>
 #include <client/game.h>
 #include <client/thing/missile.h>
+#include <client/thing/creature/walkticker.h>
 #include <client/manager/shadermanager.h>
+#include <client/manager/spritemanager.h>
 
 #include <framework/core/declarations.h>
 #include <framework/graphics/framebuffermanager.h>
@@ -35,10 +37,16 @@
 
 void MapViewPainter::draw(const MapViewPtr& mapView, const Rect& rect)
 {
+    // bring walk offsets up to date, this may also move the camera
+    g_walkTicker.update();
+
     // update visible tiles cache when needed
     if(mapView->m_mustUpdateVisibleTilesCache)
         mapView->updateVisibleTilesCache();
 
+    // upload textures composed in background
+    g_sprites.pollPrefetch();
+
     const Position cameraPosition = mapView->getCameraPosition();
     const auto redrawThing = mapView->m_frameCache.tile->canUpdate();
     const auto redrawLight = mapView->m_drawLights && mapView->m_lightView->canUpdate();
@@ -57,6 +65,7 @@ void MapViewPainter::draw(const MapViewPtr& mapView, const Rect& rect)
         if(redrawThing) {
             mapView->m_frameCache.tile->bind();
             mapView->m_frameCache.flags |= Otc::FUpdateThing;
+            g_painter->beginBatch();
         }
 
         const auto& lightView = redrawLight ? mapView->m_lightView.get() : nullptr;
@@ -121,6 +130,7 @@ void MapViewPainter::draw(const MapViewPtr& mapView, const Rect& rect)
                 g_painter->resetOpacity();
             }
 
+            g_painter->endBatch();
             mapView->m_frameCache.tile->release();
         }
     }
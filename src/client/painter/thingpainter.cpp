@@ -175,7 +175,8 @@ void ThingPainter::draw(const ThingTypePtr& thingType, const Point& dest, float
     if(animationPhase >= thingType->m_animationPhases)
         return;
 
-    const TexturePtr& texture = thingType->getTexture(animationPhase, useBlankTexture); // texture might not exists, neither its rects.
+    Point atlasOffset;
+    const TexturePtr& texture = thingType->getTexture(animationPhase, atlasOffset, useBlankTexture); // texture might not exists, neither its rects.
     if(!texture)
         return;
 
@@ -202,7 +203,7 @@ void ThingPainter::draw(const ThingTypePtr& thingType, const Point& dest, float
         if(useOpacity)
             g_painter->setColor(Color(1.0f, 1.0f, 1.0f, thingType->m_opacity));
 
-        g_painter->drawTexturedRect(screenRect, texture, textureRect);
+        g_painter->drawTexturedRect(screenRect, texture, textureRect.translated(atlasOffset));
 
         if(useOpacity)
             g_painter->resetColor();
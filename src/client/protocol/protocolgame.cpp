@@ -26,6 +26,10 @@
 #include <client/thing/creature/localplayer.h>
 #include <client/thing/creature/player.h>
 
+std::bitset<256> ProtocolGame::m_luaOpcodes;
+std::array<ProtocolGame::OpcodeStats, 256> ProtocolGame::m_opcodeStats;
+bool ProtocolGame::m_opcodeStatsEnabled = false;
+
 void ProtocolGame::login(const std::string& accountName, const std::string& accountPassword, const std::string& host, uint16 port, const std::string& characterName, const std::string& authenticatorToken, const std::string& sessionKey)
 {
     m_accountName = accountName;
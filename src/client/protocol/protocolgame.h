@@ -28,6 +28,8 @@
 #include <framework/net/protocol.h>
 #include <client/thing/creature/creature.h>
 
+#include <bitset>
+
 class ProtocolGame : public Protocol
 {
 public:
@@ -35,6 +37,17 @@ public:
     void send(const OutputMessagePtr& outputMessage) override;
 
     void sendExtendedOpcode(uint8 opcode, const std::string& buffer);
+
+    // only opcodes enabled here are offered to the lua onOpcode handler
+    static void setLuaOpcode(uint8 opcode, bool enabled) { m_luaOpcodes.set(opcode, enabled); }
+    static bool isLuaOpcode(uint8 opcode) { return m_luaOpcodes.test(opcode); }
+
+    // count and total parse time in microseconds of each received opcode
+    static void setOpcodeStatsEnabled(bool enabled) { m_opcodeStatsEnabled = enabled; }
+    static bool isOpcodeStatsEnabled() { return m_opcodeStatsEnabled; }
+    static uint32 getOpcodeCount(uint8 opcode) { return m_opcodeStats[opcode].count; }
+    static ticks_t getOpcodeParseTime(uint8 opcode) { return m_opcodeStats[opcode].time; }
+    static void resetOpcodeStats() { m_opcodeStats.fill(OpcodeStats()); }
     void sendLoginPacket(uint32 challengeTimestamp, uint8 challengeRandom);
     void sendEnterGame();
     void sendLogout();
@@ -289,6 +302,15 @@ public:
     Position getPosition(const InputMessagePtr& msg);
 
 private:
+    struct OpcodeStats {
+        uint32 count{ 0 };
+        ticks_t time{ 0 };
+    };
+
+    static std::bitset<256> m_luaOpcodes;
+    static std::array<OpcodeStats, 256> m_opcodeStats;
+    static bool m_opcodeStatsEnabled;
+
     bool m_enableSendExtendedOpcode{ false },
         m_gameInitialized{ false },
         m_mapKnown{ false },
@@ -38,15 +38,35 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
     int16 opcode = -1;
     int16 prevOpcode = -1;
 
+    // adds the time spent on one opcode to its stats when it goes out of scope
+    struct OpcodeTimer {
+        OpcodeTimer(uint8 opcode) : opcode(opcode), enabled(m_opcodeStatsEnabled), start(enabled ? stdext::micros() : 0) {}
+        ~OpcodeTimer()
+        {
+            // stats may be toggled by a lua handler while the opcode is parsed
+            if(!enabled)
+                return;
+
+            OpcodeStats& stats = m_opcodeStats[opcode];
+            ++stats.count;
+            stats.time += stdext::micros() - start;
+        }
+
+        uint8 opcode;
+        bool enabled;
+        ticks_t start;
+    };
+
     try
     {
         while(!msg->eof())
         {
             opcode = msg->getU8();
+            const OpcodeTimer timer(opcode);
 
-            // try to parse in lua first
+            // try to parse in lua first, only for opcodes that modules registered
             const int readPos = msg->getReadPos();
-            if(callLuaField<bool>("onOpcode", opcode, msg)) {
+            if(m_luaOpcodes.test(opcode) && callLuaField<bool>(LUA_KEY("onOpcode"), opcode, msg)) {
                 continue;
             }
 
@@ -1534,7 +1554,7 @@ void ProtocolGame::parseSpellCooldown(const InputMessagePtr& msg)
     const uint32 delay = msg->getU32();
 
     // TODO: verify if there are icons for spells id 170+ and remove the ternary check (if id >170 => 150)
-    g_lua.callGlobalField("g_game", "onSpellCooldown", (spellId >= 170) ? 150 : spellId, delay);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onSpellCooldown"), (spellId >= 170) ? 150 : spellId, delay);
 }
 
 void ProtocolGame::parseSpellGroupCooldown(const InputMessagePtr& msg)
@@ -1542,14 +1562,14 @@ void ProtocolGame::parseSpellGroupCooldown(const InputMessagePtr& msg)
     const uint8 groupId = msg->getU8();
     const uint32 delay = msg->getU32();
 
-    g_lua.callGlobalField("g_game", "onSpellGroupCooldown", groupId, delay);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onSpellGroupCooldown"), groupId, delay);
 }
 
 void ProtocolGame::parseMultiUseCooldown(const InputMessagePtr& msg)
 {
     const uint32 delay = msg->getU32();
 
-    g_lua.callGlobalField("g_game", "onMultiUseCooldown", delay);
+    g_lua.callGlobalField(LUA_GLOBAL_FIELD("g_game", "onMultiUseCooldown"), delay);
 }
 
 void ProtocolGame::parseTalk(const InputMessagePtr& msg)
@@ -2030,7 +2050,7 @@ void ProtocolGame::parseExtendedOpcode(const InputMessagePtr& msg)
     else if(opcode == 2)
         parsePingBack(msg);
     else
-        callLuaField("onExtendedOpcode", opcode, buffer);
+        callLuaField(LUA_KEY("onExtendedOpcode"), opcode, buffer);
 }
 
 void ProtocolGame::parseChangeMapAwareRange(const InputMessagePtr& msg)
@@ -26,6 +26,7 @@
 #include <client/thing/item.h>
 #include <client/map/lightview.h>
 #include <client/thing/creature/localplayer.h>
+#include <client/thing/creature/walkticker.h>
 #include <client/lua/luavaluecasts.h>
 #include <client/map/map.h>
 #include <client/manager/thingtypemanager.h>
@@ -186,7 +187,7 @@ void Creature::updateJump()
 
 void Creature::onPositionChange(const Position& newPos, const Position& oldPos)
 {
-    callLuaField("onPositionChange", newPos, oldPos);
+    callLuaField(LUA_KEY("onPositionChange"), newPos, oldPos);
 }
 
 void Creature::onAppear()
@@ -201,17 +202,17 @@ void Creature::onAppear()
     if(m_removed) {
         m_removed = false;
         stopWalk();
-        callLuaField("onAppear");
+        callLuaField(LUA_KEY("onAppear"));
     } // walk
     else if(m_oldPosition != m_position && m_oldPosition.isInRange(m_position, 1, 1) && m_allowAppearWalk) {
         m_allowAppearWalk = false;
         walk(m_oldPosition, m_position);
-        callLuaField("onWalk", m_oldPosition, m_position);
+        callLuaField(LUA_KEY("onWalk"), m_oldPosition, m_position);
     } // teleport
     else if(m_oldPosition != m_position) {
         stopWalk();
-        callLuaField("onDisappear");
-        callLuaField("onAppear");
+        callLuaField(LUA_KEY("onDisappear"));
+        callLuaField(LUA_KEY("onAppear"));
     } // else turn
 }
 
@@ -229,7 +230,7 @@ void Creature::onDisappear()
         self->m_removed = true;
         self->stopWalk();
 
-        self->callLuaField("onDisappear");
+        self->callLuaField(LUA_KEY("onDisappear"));
 
         // invalidate this creature position
         if(!self->isLocalPlayer())
@@ -242,7 +243,7 @@ void Creature::onDisappear()
 
 void Creature::onDeath()
 {
-    callLuaField("onDeath");
+    callLuaField(LUA_KEY("onDeath"));
 }
 
 void Creature::updateWalkAnimation()
@@ -319,21 +320,13 @@ void Creature::updateWalkingTile()
 
 void Creature::nextWalkUpdate()
 {
-    // remove any previous scheduled walk updates
-    if(m_walkUpdateEvent)
-        m_walkUpdateEvent->cancel();
-
     // do the update
     updateWalk();
 
     if(!m_walking) return;
 
     // schedules next update
-    auto self = static_self_cast<Creature>();
-    m_walkUpdateEvent = g_dispatcher.scheduleEvent([self] {
-        self->m_walkUpdateEvent = nullptr;
-        self->nextWalkUpdate();
-    }, std::max<int>(m_stepCache.duration / SPRITE_SIZE, 16));
+    g_walkTicker.schedule(static_self_cast<Creature>(), g_clock.millis() + std::max<int>(m_stepCache.duration / SPRITE_SIZE, 16));
 }
 
 void Creature::updateWalk()
@@ -363,10 +356,7 @@ void Creature::updateWalk()
 void Creature::terminateWalk()
 {
     // remove any scheduled walk update
-    if(m_walkUpdateEvent) {
-        m_walkUpdateEvent->cancel();
-        m_walkUpdateEvent = nullptr;
-    }
+    g_walkTicker.remove(this);
 
     // now the walk has ended, do any scheduled turn
     if(m_walkTurnDirection != Otc::InvalidDirection) {
@@ -416,7 +406,7 @@ void Creature::setHealthPercent(uint8 healthPercent)
 
     const uint8 oldHealthPercent = m_healthPercent;
     m_healthPercent = healthPercent;
-    callLuaField("onHealthPercentChange", healthPercent, oldHealthPercent);
+    callLuaField(LUA_KEY("onHealthPercentChange"), healthPercent, oldHealthPercent);
 
     if(isDead()) onDeath();
 }
@@ -445,7 +435,7 @@ void Creature::setOutfit(const Outfit& outfit)
 
     m_walkAnimationPhase = 0; // might happen when player is walking and outfit is changed.
 
-    callLuaField("onOutfitChange", m_outfit, oldOutfit);
+    callLuaField(LUA_KEY("onOutfitChange"), m_outfit, oldOutfit);
 
     // Cache
     {
@@ -507,7 +497,7 @@ void Creature::setSpeed(uint16 speed)
     if(m_walking)
         nextWalkUpdate();
 
-    callLuaField("onSpeedChange", m_speed, oldSpeed);
+    callLuaField(LUA_KEY("onSpeedChange"), m_speed, oldSpeed);
 }
 
 void Creature::setBaseSpeed(double baseSpeed)
@@ -516,38 +506,38 @@ void Creature::setBaseSpeed(double baseSpeed)
         const double oldBaseSpeed = m_baseSpeed;
         m_baseSpeed = baseSpeed;
 
-        callLuaField("onBaseSpeedChange", baseSpeed, oldBaseSpeed);
+        callLuaField(LUA_KEY("onBaseSpeedChange"), baseSpeed, oldBaseSpeed);
     }
 }
 
 void Creature::setSkull(uint8 skull)
 {
     m_skull = skull;
-    callLuaField("onSkullChange", m_skull);
+    callLuaField(LUA_KEY("onSkullChange"), m_skull);
 }
 
 void Creature::setShield(uint8 shield)
 {
     m_shield = shield;
-    callLuaField("onShieldChange", m_shield);
+    callLuaField(LUA_KEY("onShieldChange"), m_shield);
 }
 
 void Creature::setEmblem(uint8 emblem)
 {
     m_emblem = emblem;
-    callLuaField("onEmblemChange", m_emblem);
+    callLuaField(LUA_KEY("onEmblemChange"), m_emblem);
 }
 
 void Creature::setType(uint8 type)
 {
     m_type = type;
-    callLuaField("onTypeChange", m_type);
+    callLuaField(LUA_KEY("onTypeChange"), m_type);
 }
 
 void Creature::setIcon(uint8 icon)
 {
     m_icon = icon;
-    callLuaField("onIconChange", m_icon);
+    callLuaField(LUA_KEY("onIconChange"), m_icon);
 }
 
 void Creature::setSkullTexture(const std::string& filename)
@@ -199,11 +199,11 @@ protected:
     Timer m_walkTimer;
     Timer m_footTimer;
     TilePtr m_walkingTile;
-    ScheduledEventPtr m_walkUpdateEvent;
     ScheduledEventPtr m_walkFinishAnimEvent;
     EventPtr m_disappearEvent;
     Point m_walkOffset;
     Otc::Direction_t m_walkTurnDirection;
+    int m_walkTickerIndex{ -1 };
     Otc::Direction_t m_lastStepDirection;
     Position m_lastStepFromPosition;
     Position m_lastStepToPosition;
@@ -216,6 +216,7 @@ protected:
     Timer m_jumpTimer;
 
     friend class CreaturePainter;
+    friend class WalkTicker;
 
 private:
     struct DrawCache {
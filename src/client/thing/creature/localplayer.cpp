@@ -124,7 +124,7 @@ void LocalPlayer::cancelWalk(Otc::Direction_t direction)
     if(direction != Otc::InvalidDirection)
         setDirection(direction);
 
-    callLuaField("onCancelWalk", direction);
+    callLuaField(LUA_KEY("onCancelWalk"), direction);
 }
 
 bool LocalPlayer::autoWalk(const Position& destination)
@@ -163,7 +163,7 @@ bool LocalPlayer::autoWalk(const Position& destination)
     if(limitedPath.empty()) {
         result = g_map.findPath(m_position, destination, 10000, Otc::PathFindAllowNotSeenTiles);
         if(std::get<1>(result) != Otc::PathFindResultOk) {
-            callLuaField("onAutoWalkFail", std::get<1>(result));
+            callLuaField(LUA_KEY("onAutoWalkFail"), std::get<1>(result));
             stopAutoWalk();
             return false;
         }
@@ -272,7 +272,7 @@ void LocalPlayer::setIcons(uint32_t icons)
     const uint32_t oldIcons = m_icons;
     m_icons = icons;
 
-    callLuaField("onIconsChange", icons, oldIcons);
+    callLuaField(LUA_KEY("onIconsChange"), icons, oldIcons);
 }
 
 void LocalPlayer::setSkill(const Otc::skills_t skill, const uint8 level, const uint8 levelPercent)
@@ -288,7 +288,7 @@ void LocalPlayer::setSkill(const Otc::skills_t skill, const uint8 level, const u
         m_skills[skill].level;
         m_skills[skill].percent = levelPercent;
 
-        callLuaField("onSkillChange", skill, level, levelPercent, oldSkill.level, oldSkill.percent);
+        callLuaField(LUA_KEY("onSkillChange"), skill, level, levelPercent, oldSkill.level, oldSkill.percent);
     }
 }
 
@@ -303,7 +303,7 @@ void LocalPlayer::setBaseSkill(Otc::skills_t skill, int baseLevel)
     if(baseLevel != oldBaseLevel) {
         m_skills[skill].baseLevel = baseLevel;
 
-        callLuaField("onBaseSkillChange", skill, baseLevel, oldBaseLevel);
+        callLuaField(LUA_KEY("onBaseSkillChange"), skill, baseLevel, oldBaseLevel);
     }
 }
 
@@ -317,7 +317,7 @@ void LocalPlayer::setHealth(double health, double maxHealth)
     m_health = health;
     m_maxHealth = maxHealth;
 
-    callLuaField("onHealthChange", health, maxHealth, oldHealth, oldMaxHealth);
+    callLuaField(LUA_KEY("onHealthChange"), health, maxHealth, oldHealth, oldMaxHealth);
 
     // cannot walk while dying
     if(health == 0) {
@@ -335,7 +335,7 @@ void LocalPlayer::setFreeCapacity(double freeCapacity)
     const double oldFreeCapacity = m_freeCapacity;
     m_freeCapacity = freeCapacity;
 
-    callLuaField("onFreeCapacityChange", freeCapacity, oldFreeCapacity);
+    callLuaField(LUA_KEY("onFreeCapacityChange"), freeCapacity, oldFreeCapacity);
 }
 
 void LocalPlayer::setTotalCapacity(double totalCapacity)
@@ -345,7 +345,7 @@ void LocalPlayer::setTotalCapacity(double totalCapacity)
     const double oldTotalCapacity = m_totalCapacity;
     m_totalCapacity = totalCapacity;
 
-    callLuaField("onTotalCapacityChange", totalCapacity, oldTotalCapacity);
+    callLuaField(LUA_KEY("onTotalCapacityChange"), totalCapacity, oldTotalCapacity);
 }
 
 void LocalPlayer::setExperience(double experience)
@@ -355,7 +355,7 @@ void LocalPlayer::setExperience(double experience)
     const double oldExperience = m_experience;
     m_experience = experience;
 
-    callLuaField("onExperienceChange", experience, oldExperience);
+    callLuaField(LUA_KEY("onExperienceChange"), experience, oldExperience);
 }
 
 void LocalPlayer::setLevel(double level, double levelPercent)
@@ -368,7 +368,7 @@ void LocalPlayer::setLevel(double level, double levelPercent)
     m_level = level;
     m_levelPercent = levelPercent;
 
-    callLuaField("onLevelChange", level, levelPercent, oldLevel, oldLevelPercent);
+    callLuaField(LUA_KEY("onLevelChange"), level, levelPercent, oldLevel, oldLevelPercent);
 }
 
 void LocalPlayer::setMana(double mana, double maxMana)
@@ -381,7 +381,7 @@ void LocalPlayer::setMana(double mana, double maxMana)
     m_mana = mana;
     m_maxMana = maxMana;
 
-    callLuaField("onManaChange", mana, maxMana, oldMana, oldMaxMana);
+    callLuaField(LUA_KEY("onManaChange"), mana, maxMana, oldMana, oldMaxMana);
 }
 
 void LocalPlayer::setMagicLevel(double magicLevel, double magicLevelPercent)
@@ -394,7 +394,7 @@ void LocalPlayer::setMagicLevel(double magicLevel, double magicLevelPercent)
     m_magicLevel = magicLevel;
     m_magicLevelPercent = magicLevelPercent;
 
-    callLuaField("onMagicLevelChange", magicLevel, magicLevelPercent, oldMagicLevel, oldMagicLevelPercent);
+    callLuaField(LUA_KEY("onMagicLevelChange"), magicLevel, magicLevelPercent, oldMagicLevel, oldMagicLevelPercent);
 }
 
 void LocalPlayer::setBaseMagicLevel(double baseMagicLevel)
@@ -404,7 +404,7 @@ void LocalPlayer::setBaseMagicLevel(double baseMagicLevel)
     const double oldBaseMagicLevel = m_baseMagicLevel;
     m_baseMagicLevel = baseMagicLevel;
 
-    callLuaField("onBaseMagicLevelChange", baseMagicLevel, oldBaseMagicLevel);
+    callLuaField(LUA_KEY("onBaseMagicLevelChange"), baseMagicLevel, oldBaseMagicLevel);
 }
 
 void LocalPlayer::setSoul(double soul)
@@ -414,7 +414,7 @@ void LocalPlayer::setSoul(double soul)
     const double oldSoul = m_soul;
     m_soul = soul;
 
-    callLuaField("onSoulChange", soul, oldSoul);
+    callLuaField(LUA_KEY("onSoulChange"), soul, oldSoul);
 }
 
 void LocalPlayer::setStamina(double stamina)
@@ -424,7 +424,7 @@ void LocalPlayer::setStamina(double stamina)
     const double oldStamina = m_stamina;
     m_stamina = stamina;
 
-    callLuaField("onStaminaChange", stamina, oldStamina);
+    callLuaField(LUA_KEY("onStaminaChange"), stamina, oldStamina);
 }
 
 void LocalPlayer::setInventoryItem(Otc::InventorySlot_t inventory, const ItemPtr& item)
@@ -439,7 +439,7 @@ void LocalPlayer::setInventoryItem(Otc::InventorySlot_t inventory, const ItemPtr
     const ItemPtr oldItem = m_inventoryItems[inventory];
     m_inventoryItems[inventory] = item;
 
-    callLuaField("onInventoryChange", inventory, item, oldItem);
+    callLuaField(LUA_KEY("onInventoryChange"), inventory, item, oldItem);
 }
 
 void LocalPlayer::setVocation(uint8_t vocation)
@@ -449,7 +449,7 @@ void LocalPlayer::setVocation(uint8_t vocation)
     const uint8_t oldVocation = m_vocation;
     m_vocation = vocation;
 
-    callLuaField("onVocationChange", vocation, oldVocation);
+    callLuaField(LUA_KEY("onVocationChange"), vocation, oldVocation);
 }
 
 void LocalPlayer::setPremium(bool premium, uint32 premiumExpiration)
@@ -459,7 +459,7 @@ void LocalPlayer::setPremium(bool premium, uint32 premiumExpiration)
     m_premium = premium;
     m_premiumExpiration = premiumExpiration;
 
-    callLuaField("onPremiumChange", premium, m_premiumExpiration);
+    callLuaField(LUA_KEY("onPremiumChange"), premium, m_premiumExpiration);
 }
 
 void LocalPlayer::setRegenerationTime(double regenerationTime)
@@ -469,7 +469,7 @@ void LocalPlayer::setRegenerationTime(double regenerationTime)
     const double oldRegenerationTime = m_regenerationTime;
     m_regenerationTime = regenerationTime;
 
-    callLuaField("onRegenerationChange", regenerationTime, oldRegenerationTime);
+    callLuaField(LUA_KEY("onRegenerationChange"), regenerationTime, oldRegenerationTime);
 }
 
 void LocalPlayer::setOfflineTrainingTime(double offlineTrainingTime)
@@ -479,7 +479,7 @@ void LocalPlayer::setOfflineTrainingTime(double offlineTrainingTime)
     const double oldOfflineTrainingTime = m_offlineTrainingTime;
     m_offlineTrainingTime = offlineTrainingTime;
 
-    callLuaField("onOfflineTrainingChange", offlineTrainingTime, oldOfflineTrainingTime);
+    callLuaField(LUA_KEY("onOfflineTrainingChange"), offlineTrainingTime, oldOfflineTrainingTime);
 }
 
 void LocalPlayer::setSpells(const std::vector<uint8>& spells)
@@ -489,7 +489,7 @@ void LocalPlayer::setSpells(const std::vector<uint8>& spells)
     const std::vector<uint8> oldSpells = m_spells;
     m_spells = spells;
 
-    callLuaField("onSpellsChange", spells, oldSpells);
+    callLuaField(LUA_KEY("onSpellsChange"), spells, oldSpells);
 }
 
 void LocalPlayer::setBlessings(uint16_t blessings)
@@ -499,7 +499,7 @@ void LocalPlayer::setBlessings(uint16_t blessings)
     const uint16_t oldBlessings = m_blessings;
     m_blessings = blessings;
 
-    callLuaField("onBlessingsChange", blessings, oldBlessings);
+    callLuaField(LUA_KEY("onBlessingsChange"), blessings, oldBlessings);
 }
 
 bool LocalPlayer::hasSight(const Position& pos)
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "walkticker.h"
+#include "creature.h"
+
+#include <framework/core/eventdispatcher.h>
+#include <framework/core/framearena.h>
+
+WalkTicker g_walkTicker;
+
+void WalkTicker::terminate()
+{
+    if(m_updateEvent) {
+        m_updateEvent->cancel();
+        m_updateEvent = nullptr;
+    }
+
+    for(const Entry& entry : m_entries)
+        entry.creature->m_walkTickerIndex = -1;
+    m_entries.clear();
+}
+
+void WalkTicker::schedule(const CreaturePtr& creature, ticks_t nextUpdate)
+{
+    if(creature->m_walkTickerIndex >= 0) {
+        m_entries[creature->m_walkTickerIndex].nextUpdate = nextUpdate;
+        return;
+    }
+
+    creature->m_walkTickerIndex = m_entries.size();
+    m_entries.push_back({ nextUpdate, creature });
+
+    if(!m_updateEvent)
+        m_updateEvent = g_dispatcher.cycleEvent([this] { update(); }, UPDATE_DELAY);
+}
+
+void WalkTicker::remove(Creature* creature)
+{
+    const int index = creature->m_walkTickerIndex;
+    if(index < 0)
+        return;
+
+    // keep the array dense, the last entry takes the place of the removed one
+    creature->m_walkTickerIndex = -1;
+    if(index != static_cast<int>(m_entries.size()) - 1) {
+        m_entries[index] = std::move(m_entries.back());
+        m_entries[index].creature->m_walkTickerIndex = index;
+    }
+    m_entries.pop_back();
+
+    if(m_entries.empty() && m_updateEvent) {
+        m_updateEvent->cancel();
+        m_updateEvent = nullptr;
+    }
+}
+
+void WalkTicker::update()
+{
+    const ticks_t now = g_clock.millis();
+
+    // collect first, updates may end walks or start new ones and reshape the array
+    FrameVector<CreaturePtr> due(&g_frameArena);
+    for(const Entry& entry : m_entries) {
+        if(entry.nextUpdate <= now)
+            due.push_back(entry.creature);
+    }
+
+    for(const CreaturePtr& creature : due) {
+        const int index = creature->m_walkTickerIndex;
+        if(index < 0 || m_entries[index].nextUpdate > now)
+            continue;
+
+        creature->nextWalkUpdate();
+    }
+}
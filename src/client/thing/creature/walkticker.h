@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef WALKTICKER_H
+#define WALKTICKER_H
+
+#include <client/declarations.h>
+#include <framework/core/declarations.h>
+
+ /**
+  * Drives the walk updates of every walking creature from a single place instead of an event per creature.
+  * Creatures are kept in a dense array with the time of their next update, the map painter runs the due
+  * updates right before drawing and a single cycle event keeps walks going while nothing is drawn.
+  */
+class WalkTicker
+{
+public:
+    enum {
+        UPDATE_DELAY = 16
+    };
+
+    void terminate();
+
+    // registers the creature or moves its next update
+    void schedule(const CreaturePtr& creature, ticks_t nextUpdate);
+    void remove(Creature* creature);
+
+    // runs the walk updates that are due
+    void update();
+
+    uint32 size() { return m_entries.size(); }
+
+private:
+    struct Entry
+    {
+        ticks_t nextUpdate;
+        CreaturePtr creature;
+    };
+
+    std::vector<Entry> m_entries;
+    ScheduledEventPtr m_updateEvent;
+};
+
+extern WalkTicker g_walkTicker;
+
+#endif
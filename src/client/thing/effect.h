@@ -27,6 +27,7 @@
 #include <framework/core/timer.h>
 #include <client/thing/thing.h>
 #include <client/painter/thingpainter.h>
+#include <framework/util/objectpool.h>
 
  // @bindclass
 class Effect : public Thing
@@ -34,6 +35,10 @@ class Effect : public Thing
 public:
     Effect() = default;
 
+    // effects come and go by the thousand in fights, recycle their memory
+    static void* operator new(size_t size) { return ObjectPool<Effect>::allocate(size); }
+    static void operator delete(void* p, size_t size) { ObjectPool<Effect>::deallocate(p, size); }
+
     void setId(uint32 id) override;
     uint32 getId() override { return m_id; }
 
@@ -28,6 +28,7 @@
 #include <client/thing/type/itemtype.h>
 #include <client/thing/thing.h>
 #include <client/painter/thingpainter.h>
+#include <framework/util/objectpool.h>
 
 enum ItemAttr : uint8
 {
@@ -79,6 +80,10 @@ public:
     Item() = default;
     ~Item() override = default;
 
+    // items are created for every tile and container update, recycle their memory
+    static void* operator new(size_t size) { return ObjectPool<Item>::allocate(size); }
+    static void operator delete(void* p, size_t size) { ObjectPool<Item>::deallocate(p, size); }
+
     static ItemPtr create(int id);
     static ItemPtr createFromOtb(int id);
 
@@ -98,6 +103,7 @@ public:
     std::string getName();
     bool isValid();
 
+    // throws on malformed attributes, may run on loader threads
     void unserializeItem(const BinaryTreePtr& in);
     void serializeItem(const OutputBinaryTreePtr& out);
 
@@ -27,11 +27,16 @@
 #include <framework/core/timer.h>
 #include <client/thing/thing.h>
 #include <client/painter/thingpainter.h>
+#include <framework/util/objectpool.h>
 
  // @bindclass
 class Missile : public Thing
 {
 public:
+    // missiles are as short lived as effects, recycle their memory
+    static void* operator new(size_t size) { return ObjectPool<Missile>::allocate(size); }
+    static void operator delete(void* p, size_t size) { ObjectPool<Missile>::deallocate(p, size); }
+
     void setId(uint32 id) override;
     void setPath(const Position& fromPosition, const Position& toPosition);
 
@@ -27,6 +27,7 @@
 #include <framework/graphics/cachedtext.h>
 #include <framework/graphics/fontmanager.h>
 #include <client/thing/thing.h>
+#include <framework/util/objectpool.h>
 
  // @bindclass
 class AnimatedText : public Thing
@@ -34,6 +35,10 @@ class AnimatedText : public Thing
 public:
     AnimatedText();
 
+    // damage and heal texts are created for every hit, recycle their memory
+    static void* operator new(size_t size) { return ObjectPool<AnimatedText>::allocate(size); }
+    static void operator delete(void* p, size_t size) { ObjectPool<AnimatedText>::deallocate(p, size); }
+
     void drawText(const Point& dest, const Rect& visibleRect);
 
     void setColor(uint8 color);
@@ -46,13 +46,13 @@ ItemPtr Container::getItem(int slot)
 
 void Container::onOpen(const ContainerPtr& previousContainer)
 {
-    callLuaField("onOpen", previousContainer);
+    callLuaField(LUA_KEY("onOpen"), previousContainer);
 }
 
 void Container::onClose()
 {
     m_closed = true;
-    callLuaField("onClose");
+    callLuaField(LUA_KEY("onClose"));
 }
 
 void Container::onAddItem(const ItemPtr& item, int slot)
@@ -62,7 +62,7 @@ void Container::onAddItem(const ItemPtr& item, int slot)
     ++m_size;
     // indicates that there is a new item on next page
     if(m_hasPages && slot > m_capacity) {
-        callLuaField("onSizeChange", m_size);
+        callLuaField(LUA_KEY("onSizeChange"), m_size);
         return;
     }
 
@@ -72,8 +72,8 @@ void Container::onAddItem(const ItemPtr& item, int slot)
         m_items.push_back(item);
     updateItemsPositions();
 
-    callLuaField("onSizeChange", m_size);
-    callLuaField("onAddItem", slot, item);
+    callLuaField(LUA_KEY("onSizeChange"), m_size);
+    callLuaField(LUA_KEY("onAddItem"), slot, item);
 }
 
 ItemPtr Container::findItemById(uint itemId, int subType)
@@ -103,7 +103,7 @@ void Container::onUpdateItem(int slot, const ItemPtr& item)
     m_items[slot] = item;
     item->setPosition(getSlotPosition(slot));
 
-    callLuaField("onUpdateItem", slot, item, oldItem);
+    callLuaField(LUA_KEY("onUpdateItem"), slot, item, oldItem);
 }
 
 void Container::onRemoveItem(int slot, const ItemPtr& lastItem)
@@ -111,7 +111,7 @@ void Container::onRemoveItem(int slot, const ItemPtr& lastItem)
     slot -= m_firstIndex;
     if(m_hasPages && slot >= static_cast<int>(m_items.size())) {
         --m_size;
-        callLuaField("onSizeChange", m_size);
+        callLuaField(LUA_KEY("onSizeChange"), m_size);
         return;
     }
 
@@ -132,8 +132,8 @@ void Container::onRemoveItem(int slot, const ItemPtr& lastItem)
 
     updateItemsPositions();
 
-    callLuaField("onSizeChange", m_size);
-    callLuaField("onRemoveItem", slot, item);
+    callLuaField(LUA_KEY("onSizeChange"), m_size);
+    callLuaField(LUA_KEY("onRemoveItem"), slot, item);
 }
 
 void Container::updateItemsPositions()
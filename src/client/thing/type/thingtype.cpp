@@ -71,31 +71,31 @@ void ThingType::serialize(const FileStreamPtr& fin)
         }
         case ThingAttrLight:
         {
-            const Light light = m_attribs.get<Light>(attr);
-            fin->addU16(light.intensity);
-            fin->addU16(light.color);
+            fin->addU16(m_light.intensity);
+            fin->addU16(m_light.color);
             break;
         }
         case ThingAttrMarket:
         {
-            auto market = m_attribs.get<MarketData>(attr);
-            fin->addU16(market.category);
-            fin->addU16(market.tradeAs);
-            fin->addU16(market.showAs);
-            fin->addString(market.name);
-            fin->addU16(market.restrictVocation);
-            fin->addU16(market.requiredLevel);
+            fin->addU16(m_marketData.category);
+            fin->addU16(m_marketData.tradeAs);
+            fin->addU16(m_marketData.showAs);
+            fin->addString(m_marketData.name);
+            fin->addU16(m_marketData.restrictVocation);
+            fin->addU16(m_marketData.requiredLevel);
             break;
         }
-        case ThingAttrUsable:
         case ThingAttrElevation:
+            fin->addU16(m_elevation);
+            break;
+        case ThingAttrUsable:
         case ThingAttrGround:
         case ThingAttrWritable:
         case ThingAttrWritableOnce:
         case ThingAttrMinimapColor:
         case ThingAttrCloth:
         case ThingAttrLensHelp:
-            fin->addU16(m_attribs.get<uint16>(attr));
+            fin->addU16(getAttrValue(static_cast<ThingAttr>(attr)));
             break;
         default:
             break;
@@ -143,10 +143,10 @@ void ThingType::unserialize(uint16 clientId, ThingCategory category, const FileS
         if(attr == 16)
             attr = ThingAttrNoMoveAnimation;
         else if(attr == 254) { // Usable
-            m_attribs.set(ThingAttrUsable, true);
+            setAttr(ThingAttrUsable, 1);
             continue;
         } else if(attr == 35) { // Default Action
-            m_attribs.set(ThingAttrDefaultAction, fin->getU16());
+            setAttr(ThingAttrDefaultAction, fin->getU16());
             continue;
         } else if(attr > 16)
             attr -= 1;
@@ -156,33 +156,31 @@ void ThingType::unserialize(uint16 clientId, ThingCategory category, const FileS
         {
             m_displacement.x = fin->getU16();
             m_displacement.y = fin->getU16();
-            m_attribs.set(attr, true);
+            m_flags.set(attr);
             break;
         }
         case ThingAttrLight:
         {
-            Light light;
-            light.intensity = fin->getU16();
-            light.color = fin->getU16();
-            m_attribs.set(attr, light);
+            m_light.intensity = fin->getU16();
+            m_light.color = fin->getU16();
+            m_flags.set(attr);
             break;
         }
         case ThingAttrMarket:
         {
-            MarketData market;
-            market.category = fin->getU16();
-            market.tradeAs = fin->getU16();
-            market.showAs = fin->getU16();
-            market.name = fin->getString();
-            market.restrictVocation = fin->getU16();
-            market.requiredLevel = fin->getU16();
-            m_attribs.set(attr, market);
+            m_marketData.category = fin->getU16();
+            m_marketData.tradeAs = fin->getU16();
+            m_marketData.showAs = fin->getU16();
+            m_marketData.name = fin->getString();
+            m_marketData.restrictVocation = fin->getU16();
+            m_marketData.requiredLevel = fin->getU16();
+            m_flags.set(attr);
             break;
         }
         case ThingAttrElevation:
         {
             m_elevation = fin->getU16();
-            m_attribs.set(attr, m_elevation);
+            m_flags.set(attr);
             break;
         }
         case ThingAttrUsable:
@@ -192,10 +190,10 @@ void ThingType::unserialize(uint16 clientId, ThingCategory category, const FileS
         case ThingAttrMinimapColor:
         case ThingAttrCloth:
         case ThingAttrLensHelp:
-            m_attribs.set(attr, fin->getU16());
+            setAttr(static_cast<ThingAttr>(attr), fin->getU16());
             break;
         default:
-            m_attribs.set(attr, true);
+            m_flags.set(attr);
             break;
         }
     }
@@ -336,23 +334,55 @@ void ThingType::unserializeOtml(const OTMLNodePtr& node)
         if(node2->tag() == "opacity")
             m_opacity = node2->value<float>();
         else if(node2->tag() == "notprewalkable")
-            m_attribs.set(ThingAttrNotPreWalkable, node2->value<bool>());
+            m_flags.set(ThingAttrNotPreWalkable, node2->value<bool>());
         else if(node2->tag() == "image")
             m_customImage = node2->value();
         else if(node2->tag() == "full-ground") {
-            if(node2->value<bool>())
-                m_attribs.set(ThingAttrFullGround, true);
-            else
-                m_attribs.remove(ThingAttrFullGround);
+            m_flags.set(ThingAttrFullGround, node2->value<bool>());
         }
     }
 }
 
 const TexturePtr& ThingType::getTexture(int animationPhase, bool allBlank)
 {
-    TexturePtr& animationPhaseTexture = (allBlank ? m_blankTextures : m_textures)[animationPhase];
-    if(animationPhaseTexture) return animationPhaseTexture;
+    Point atlasOffset;
+    return getTexture(animationPhase, atlasOffset, allBlank);
+}
+
+const TexturePtr& ThingType::getTexture(int animationPhase, Point& atlasOffset, bool allBlank)
+{
+    TextureData& data = (allBlank ? m_blankTextures : m_textures)[animationPhase];
+    if(data.texture) return data.texture;
+
+    TextureAtlas& atlas = g_sprites.getAtlas();
+    if(data.region.page != -1) {
+        if(atlas.isValid(data.region)) {
+            atlasOffset = data.region.rect.topLeft();
+            return atlas.getTexture(data.region);
+        }
+
+        // the atlas page was evicted, the image must be built again
+        data.region = AtlasRegion();
+    }
 
+    // a prefetch of this texture may already be composing it
+    TextureImage textureImage;
+    if(allBlank || !g_sprites.takePrefetch(this, animationPhase, textureImage))
+        buildTextureImage(animationPhase, allBlank, textureImage);
+    return setTextureImage(animationPhase, allBlank, textureImage, atlasOffset);
+}
+
+bool ThingType::isTextureLoaded(int animationPhase)
+{
+    if(animationPhase < 0 || animationPhase >= static_cast<int>(m_textures.size()))
+        return true;
+
+    const TextureData& data = m_textures[animationPhase];
+    return data.texture || g_sprites.getAtlas().isValid(data.region);
+}
+
+void ThingType::buildTextureImage(int animationPhase, bool allBlank, TextureImage& textureImage)
+{
     bool useCustomImage = false;
     if(animationPhase == 0 && !m_customImage.empty())
         useCustomImage = true;
@@ -370,9 +400,10 @@ const TexturePtr& ThingType::getTexture(int animationPhase, bool allBlank)
     const Size textureSize = getBestTextureDimension(m_size.width(), m_size.height(), indexSize);
     const ImagePtr fullImage = useCustomImage ? Image::load(m_customImage) : ImagePtr(new Image(textureSize * SPRITE_SIZE));
 
-    m_texturesFramesRects[animationPhase].resize(indexSize);
-    m_texturesFramesOriginRects[animationPhase].resize(indexSize);
-    m_texturesFramesOffsets[animationPhase].resize(indexSize);
+    textureImage.image = fullImage;
+    textureImage.framesRects.resize(indexSize);
+    textureImage.framesOriginRects.resize(indexSize);
+    textureImage.framesOffsets.resize(indexSize);
     for(int z = 0; z < m_numPatternZ; ++z) {
         for(int y = 0; y < m_numPatternY; ++y) {
             for(int x = 0; x < m_numPatternX; ++x) {
@@ -387,7 +418,10 @@ const TexturePtr& ThingType::getTexture(int animationPhase, bool allBlank)
                         for(int h = 0; h < m_size.height(); ++h) {
                             for(int w = 0; w < m_size.width(); ++w) {
                                 const uint spriteIndex = getSpriteIndex(w, h, spriteMask ? 1 : l, x, y, z, animationPhase);
-                                ImagePtr spriteImage = g_sprites.getSpriteImage(m_spritesIndex[spriteIndex]);
+                                bool outOfRange = false;
+                                ImagePtr spriteImage = g_sprites.getSpriteImage(m_spritesIndex[spriteIndex], &outOfRange);
+                                if(outOfRange)
+                                    textureImage.outOfRangeSprites.push_back(m_spritesIndex[spriteIndex]);
                                 if(!spriteImage) fullImage->setTransparentPixel(true);
                                 else {
                                     if(spriteIndex == 0) {
@@ -424,16 +458,37 @@ const TexturePtr& ThingType::getTexture(int animationPhase, bool allBlank)
                         }
                     }
 
-                    m_texturesFramesRects[animationPhase][frameIndex] = drawRect;
-                    m_texturesFramesOriginRects[animationPhase][frameIndex] = Rect(framePos, Size(m_size.width(), m_size.height()) * SPRITE_SIZE);
-                    m_texturesFramesOffsets[animationPhase][frameIndex] = drawRect.topLeft() - framePos;
+                    textureImage.framesRects[frameIndex] = drawRect;
+                    textureImage.framesOriginRects[frameIndex] = Rect(framePos, Size(m_size.width(), m_size.height()) * SPRITE_SIZE);
+                    textureImage.framesOffsets[frameIndex] = drawRect.topLeft() - framePos;
                 }
             }
         }
     }
+}
 
-    animationPhaseTexture = TexturePtr(new Texture(fullImage, true));
-    return animationPhaseTexture;
+const TexturePtr& ThingType::setTextureImage(int animationPhase, bool allBlank, const TextureImage& textureImage, Point& atlasOffset)
+{
+    TextureData& data = (allBlank ? m_blankTextures : m_textures)[animationPhase];
+    const ImagePtr& fullImage = textureImage.image;
+
+    for(const int id : textureImage.outOfRangeSprites)
+        g_logger.error(stdext::format("Failed to get sprite id %d: out of range", id));
+
+    m_texturesFramesRects[animationPhase] = textureImage.framesRects;
+    m_texturesFramesOriginRects[animationPhase] = textureImage.framesOriginRects;
+    m_texturesFramesOffsets[animationPhase] = textureImage.framesOffsets;
+
+    data.opaque = !fullImage->hasTransparentPixel();
+
+    TextureAtlas& atlas = g_sprites.getAtlas();
+    if(atlas.insert(fullImage, data.region)) {
+        atlasOffset = data.region.rect.topLeft();
+        return atlas.getTexture(data.region);
+    }
+
+    data.texture = TexturePtr(new Texture(fullImage, true));
+    return data.texture;
 }
 
 Size ThingType::getBestTextureDimension(int w, int h, int count)
@@ -502,12 +557,66 @@ int ThingType::getExactSize(int layer, int xPattern, int yPattern, int zPattern,
     return std::max<int>(size.width(), size.height());
 }
 
+void ThingType::setAttr(ThingAttr attr, uint16 value)
+{
+    m_flags.set(attr);
+    switch(attr) {
+    case ThingAttrGround:
+        m_values.groundSpeed = value;
+        break;
+    case ThingAttrWritable:
+        m_values.writable = value;
+        break;
+    case ThingAttrWritableOnce:
+        m_values.writableOnce = value;
+        break;
+    case ThingAttrMinimapColor:
+        m_values.minimapColor = value;
+        break;
+    case ThingAttrCloth:
+        m_values.cloth = value;
+        break;
+    case ThingAttrLensHelp:
+        m_values.lensHelp = value;
+        break;
+    case ThingAttrUsable:
+        m_values.usable = value;
+        break;
+    case ThingAttrDefaultAction:
+        m_values.defaultAction = value;
+        break;
+    default:
+        break;
+    }
+}
+
+uint16 ThingType::getAttrValue(ThingAttr attr)
+{
+    switch(attr) {
+    case ThingAttrGround:
+        return m_values.groundSpeed;
+    case ThingAttrWritable:
+        return m_values.writable;
+    case ThingAttrWritableOnce:
+        return m_values.writableOnce;
+    case ThingAttrMinimapColor:
+        return m_values.minimapColor;
+    case ThingAttrCloth:
+        return m_values.cloth;
+    case ThingAttrLensHelp:
+        return m_values.lensHelp;
+    case ThingAttrUsable:
+        return m_values.usable;
+    case ThingAttrDefaultAction:
+        return m_values.defaultAction;
+    default:
+        return 0;
+    }
+}
+
 void ThingType::setPathable(bool var)
 {
-    if(var == true)
-        m_attribs.remove(ThingAttrNotPathable);
-    else
-        m_attribs.set(ThingAttrNotPathable, true);
+    m_flags.set(ThingAttrNotPathable, !var);
 }
 
 int ThingType::getAnimationPhases()
@@ -30,10 +30,13 @@
 #include <framework/core/declarations.h>
 #include <framework/graphics/coordsbuffer.h>
 #include <framework/graphics/texture.h>
+#include <framework/graphics/textureatlas.h>
 #include <framework/luaengine/luaobject.h>
 #include <framework/net/server.h>
 #include <framework/otml/declarations.h>
 
+#include <bitset>
+
 #include <framework/core/declarations.h>
 #include <framework/core/scheduledevent.h>
 
@@ -140,8 +143,8 @@ public:
     uint16 getId() { return m_id; }
     ThingCategory getCategory() { return m_category; }
 
-    Light getLight() { return m_attribs.get<Light>(ThingAttrLight); }
-    MarketData getMarketData() { return m_attribs.get<MarketData>(ThingAttrMarket); }
+    Light getLight() { return m_light; }
+    MarketData getMarketData() { return m_marketData; }
 
     Size getSize() { return m_size; }
     int getWidth() { return m_size.width(); }
@@ -162,73 +165,111 @@ public:
     int getDisplacementY() { return getDisplacement().y; }
     int getElevation() { return m_elevation; }
 
-    int getGroundSpeed() { return m_attribs.get<uint16>(ThingAttrGround); }
-    int getMaxTextLength() { return m_attribs.has(ThingAttrWritableOnce) ? m_attribs.get<uint16>(ThingAttrWritableOnce) : m_attribs.get<uint16>(ThingAttrWritable); }
+    int getGroundSpeed() { return m_values.groundSpeed; }
+    int getMaxTextLength() { return m_flags[ThingAttrWritableOnce] ? m_values.writableOnce : m_values.writable; }
 
-    int getMinimapColor() { return m_attribs.get<uint16>(ThingAttrMinimapColor); }
-    int getLensHelp() { return m_attribs.get<uint16>(ThingAttrLensHelp); }
-    int getClothSlot() { return m_attribs.get<uint16>(ThingAttrCloth); }
+    int getMinimapColor() { return m_values.minimapColor; }
+    int getLensHelp() { return m_values.lensHelp; }
+    int getClothSlot() { return m_values.cloth; }
 
-    bool hasAttr(ThingAttr attr) { return m_attribs.has(attr); }
+    bool hasAttr(ThingAttr attr) { return m_flags[attr]; }
 
     bool isNull() { return m_null; }
-    bool isGround() { return m_attribs.has(ThingAttrGround); }
-    bool isGroundBorder() { return m_attribs.has(ThingAttrGroundBorder); }
-    bool isOnBottom() { return m_attribs.has(ThingAttrOnBottom); }
-    bool isOnTop() { return m_attribs.has(ThingAttrOnTop); }
-    bool isContainer() { return m_attribs.has(ThingAttrContainer); }
-    bool isStackable() { return m_attribs.has(ThingAttrStackable); }
-    bool isForceUse() { return m_attribs.has(ThingAttrForceUse); }
-    bool isMultiUse() { return m_attribs.has(ThingAttrMultiUse); }
-    bool isWritable() { return m_attribs.has(ThingAttrWritable); }
-    bool isChargeable() { return m_attribs.has(ThingAttrChargeable); }
-    bool isWritableOnce() { return m_attribs.has(ThingAttrWritableOnce); }
-    bool isFluidContainer() { return m_attribs.has(ThingAttrFluidContainer); }
-    bool isSplash() { return m_attribs.has(ThingAttrSplash); }
-    bool isNotWalkable() { return m_attribs.has(ThingAttrNotWalkable); }
-    bool isNotMoveable() { return m_attribs.has(ThingAttrNotMoveable); }
-    bool blockProjectile() { return m_attribs.has(ThingAttrBlockProjectile); }
-    bool isNotPathable() { return m_attribs.has(ThingAttrNotPathable); }
-    bool isPickupable() { return m_attribs.has(ThingAttrPickupable); }
-    bool isHangable() { return m_attribs.has(ThingAttrHangable); }
-    bool isHookSouth() { return m_attribs.has(ThingAttrHookSouth); }
-    bool isHookEast() { return m_attribs.has(ThingAttrHookEast); }
-    bool isRotateable() { return m_attribs.has(ThingAttrRotateable); }
-    bool hasLight() { return m_attribs.has(ThingAttrLight); }
-    bool isDontHide() { return m_attribs.has(ThingAttrDontHide); }
-    bool isTranslucent() { return m_attribs.has(ThingAttrTranslucent); }
-    bool hasDisplacement() { return m_attribs.has(ThingAttrDisplacement); }
-    bool hasElevation() { return m_attribs.has(ThingAttrElevation); }
-    bool isLyingCorpse() { return m_attribs.has(ThingAttrLyingCorpse); }
-    bool isAnimateAlways() { return m_attribs.has(ThingAttrAnimateAlways); }
-    bool hasMiniMapColor() { return m_attribs.has(ThingAttrMinimapColor); }
-    bool hasLensHelp() { return m_attribs.has(ThingAttrLensHelp); }
-    bool isFullGround() { return m_attribs.has(ThingAttrFullGround); }
-    bool isIgnoreLook() { return m_attribs.has(ThingAttrLook); }
-    bool isCloth() { return m_attribs.has(ThingAttrCloth); }
-    bool isMarketable() { return m_attribs.has(ThingAttrMarket); }
-    bool isUsable() { return m_attribs.has(ThingAttrUsable); }
-    bool isWrapable() { return m_attribs.has(ThingAttrWrapable); }
-    bool isUnwrapable() { return m_attribs.has(ThingAttrUnwrapable); }
-    bool isTopEffect() { return m_attribs.has(ThingAttrTopEffect); }
-    bool hasAction() { return m_attribs.has(ThingAttrDefaultAction); }
-    bool isOpaque() { return (isFullGround() || (hasTexture() && getTexture(0)->isOpaque())); }
+    bool isGround() { return m_flags[ThingAttrGround]; }
+    bool isGroundBorder() { return m_flags[ThingAttrGroundBorder]; }
+    bool isOnBottom() { return m_flags[ThingAttrOnBottom]; }
+    bool isOnTop() { return m_flags[ThingAttrOnTop]; }
+    bool isContainer() { return m_flags[ThingAttrContainer]; }
+    bool isStackable() { return m_flags[ThingAttrStackable]; }
+    bool isForceUse() { return m_flags[ThingAttrForceUse]; }
+    bool isMultiUse() { return m_flags[ThingAttrMultiUse]; }
+    bool isWritable() { return m_flags[ThingAttrWritable]; }
+    bool isChargeable() { return m_flags[ThingAttrChargeable]; }
+    bool isWritableOnce() { return m_flags[ThingAttrWritableOnce]; }
+    bool isFluidContainer() { return m_flags[ThingAttrFluidContainer]; }
+    bool isSplash() { return m_flags[ThingAttrSplash]; }
+    bool isNotWalkable() { return m_flags[ThingAttrNotWalkable]; }
+    bool isNotMoveable() { return m_flags[ThingAttrNotMoveable]; }
+    bool blockProjectile() { return m_flags[ThingAttrBlockProjectile]; }
+    bool isNotPathable() { return m_flags[ThingAttrNotPathable]; }
+    bool isPickupable() { return m_flags[ThingAttrPickupable]; }
+    bool isHangable() { return m_flags[ThingAttrHangable]; }
+    bool isHookSouth() { return m_flags[ThingAttrHookSouth]; }
+    bool isHookEast() { return m_flags[ThingAttrHookEast]; }
+    bool isRotateable() { return m_flags[ThingAttrRotateable]; }
+    bool hasLight() { return m_flags[ThingAttrLight]; }
+    bool isDontHide() { return m_flags[ThingAttrDontHide]; }
+    bool isTranslucent() { return m_flags[ThingAttrTranslucent]; }
+    bool hasDisplacement() { return m_flags[ThingAttrDisplacement]; }
+    bool hasElevation() { return m_flags[ThingAttrElevation]; }
+    bool isLyingCorpse() { return m_flags[ThingAttrLyingCorpse]; }
+    bool isAnimateAlways() { return m_flags[ThingAttrAnimateAlways]; }
+    bool hasMiniMapColor() { return m_flags[ThingAttrMinimapColor]; }
+    bool hasLensHelp() { return m_flags[ThingAttrLensHelp]; }
+    bool isFullGround() { return m_flags[ThingAttrFullGround]; }
+    bool isIgnoreLook() { return m_flags[ThingAttrLook]; }
+    bool isCloth() { return m_flags[ThingAttrCloth]; }
+    bool isMarketable() { return m_flags[ThingAttrMarket]; }
+    bool isUsable() { return m_flags[ThingAttrUsable]; }
+    bool isWrapable() { return m_flags[ThingAttrWrapable]; }
+    bool isUnwrapable() { return m_flags[ThingAttrUnwrapable]; }
+    bool isTopEffect() { return m_flags[ThingAttrTopEffect]; }
+    bool hasAction() { return m_flags[ThingAttrDefaultAction]; }
+    bool isOpaque() { return (isFullGround() || (hasTexture() && getTexture(0) && m_textures[0].opaque)); }
     bool isTall(const bool useRealSize = false) { return useRealSize ? getRealSize() > SPRITE_SIZE : getHeight() > 1; }
 
     std::vector<int> getSprites() { return m_spritesIndex; }
 
     // additional
     float getOpacity() { return m_opacity; }
-    bool isNotPreWalkable() { return m_attribs.has(ThingAttrNotPreWalkable); }
+    bool isNotPreWalkable() { return m_flags[ThingAttrNotPreWalkable]; }
     void setPathable(bool var);
     int getExactHeight();
     const TexturePtr& getTexture(int animationPhase, bool allBlank = false);
+    const TexturePtr& getTexture(int animationPhase, Point& atlasOffset, bool allBlank = false);
+
+    // composed image of one animation phase and the rects of its frames,
+    // it is built without touching gl so it can be done by a worker thread
+    struct TextureImage {
+        ImagePtr image;
+        std::vector<Rect> framesRects, framesOriginRects;
+        std::vector<Point> framesOffsets;
+        // reported by setTextureImage, the image may be built on a worker thread
+        std::vector<int> outOfRangeSprites;
+    };
+
+    bool isTextureLoaded(int animationPhase);
+    bool canBuildTextureAsync(int animationPhase) { return animationPhase != 0 || m_customImage.empty(); }
+    void buildTextureImage(int animationPhase, bool allBlank, TextureImage& textureImage);
+    const TexturePtr& setTextureImage(int animationPhase, bool allBlank, const TextureImage& textureImage, Point& atlasOffset);
 
     friend class ThingPainter;
 
 private:
+    struct TextureData {
+        // standalone texture, only used when the image doesn't fit in the atlas
+        TexturePtr texture;
+        AtlasRegion region;
+        bool opaque{ false };
+    };
+
+    // plain values of the numeric attributes, only meaningful when the attribute flag is set
+    struct AttrValues {
+        uint16 groundSpeed{ 0 };
+        uint16 writable{ 0 };
+        uint16 writableOnce{ 0 };
+        uint16 minimapColor{ 0 };
+        uint16 cloth{ 0 };
+        uint16 lensHelp{ 0 };
+        uint16 usable{ 0 };
+        uint16 defaultAction{ 0 };
+    };
+
     static Size getBestTextureDimension(int w, int h, int count);
 
+    void setAttr(ThingAttr attr, uint16 value);
+    uint16 getAttrValue(ThingAttr attr);
+
     bool hasTexture() const { return !m_textures.empty(); }
 
     uint getSpriteIndex(int w, int h, int l, int x, int y, int z, int a);
@@ -237,7 +278,10 @@ private:
     ThingCategory m_category{ ThingInvalidCategory };
     uint16 m_id{ 0 };
     bool m_null{ true };
-    stdext::dynamic_storage<uint8> m_attribs;
+    std::bitset<ThingLastAttr + 1> m_flags;
+    AttrValues m_values;
+    Light m_light;
+    MarketData m_marketData{};
 
     Size m_size;
     Point m_displacement;
@@ -258,7 +302,7 @@ private:
 
     std::vector<int> m_spritesIndex;
 
-    std::vector<TexturePtr> m_textures,
+    std::vector<TextureData> m_textures,
         m_blankTextures;
 
     std::vector<std::vector<Rect>> m_texturesFramesRects,
@@ -149,6 +149,8 @@ void Application::poll()
     Connection::poll();
 #endif
 
+    // continuations of finished background tasks run with the other events
+    g_asyncDispatcher.poll();
     g_dispatcher.poll();
 
     // poll connection again to flush pending write
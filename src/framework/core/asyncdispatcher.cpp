@@ -21,52 +21,236 @@
  */
 
 #include "asyncdispatcher.h"
+#include "eventdispatcher.h"
 
 AsyncDispatcher g_asyncDispatcher;
 
+namespace
+{
+    // index of the worker running on this thread, -1 outside of the workers
+    thread_local int t_workerIndex = -1;
+}
+
 void AsyncDispatcher::init()
 {
-    spawn_thread();
+    // leave one core to the main thread
+    const int threads = std::max<int>(1, std::min<int>(MAX_THREADS, static_cast<int>(std::thread::hardware_concurrency()) - 1));
+
+    m_running = true;
+    for(int i = 0; i < threads; ++i)
+        m_workers.emplace_back(new Worker);
+    for(int i = 0; i < threads; ++i)
+        m_workers[i]->thread = std::thread([this, i] { exec_loop(i); });
 }
 
 void AsyncDispatcher::terminate()
 {
-    stop();
-    m_tasks.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+        m_condition.notify_all();
+    }
+
+    for(const auto& worker : m_workers)
+        worker->thread.join();
+    m_workers.clear();
+    m_pendingTasks = 0;
+
+    std::lock_guard<std::mutex> lock(m_continuationsMutex);
+    m_continuations.clear();
 }
 
-void AsyncDispatcher::spawn_thread()
+void AsyncDispatcher::poll()
 {
-    m_running = true;
-    m_threads.emplace_back([this] { exec_loop(); });
+    std::vector<std::function<void()>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(m_continuationsMutex);
+        continuations.swap(m_continuations);
+    }
+
+    for(auto& continuation : continuations)
+        g_dispatcher.addEvent(continuation);
 }
 
-void AsyncDispatcher::stop()
+void AsyncDispatcher::dispatch(std::function<void()> task)
 {
-    m_mutex.lock();
-    m_running = false;
-    m_condition.notify_all();
-    m_mutex.unlock();
-    for(std::thread& thread : m_threads)
-        thread.join();
-    m_threads.clear();
-};
+    push(std::move(task), nullptr);
+}
 
-void AsyncDispatcher::exec_loop()
+void AsyncDispatcher::push(std::function<void()> task, AsyncTaskGroup* group)
 {
-    std::unique_lock<std::mutex> lock(m_mutex);
+    if(m_workers.empty()) {
+        task();
+        return;
+    }
+
+    if(group)
+        ++group->m_queued;
+
+    // tasks spawned by a worker stay on its queue, the others are spread among the workers
+    const int index = t_workerIndex >= 0 ? t_workerIndex : m_nextWorker++ % m_workers.size();
+    Worker& worker = *m_workers[index];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back({ std::move(task), group });
+    }
+
+    ++m_pendingTasks;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_condition.notify_one();
+}
+
+void AsyncDispatcher::parallelFor(int begin, int end, const std::function<void(int, int)>& func, int grain)
+{
+    if(begin >= end)
+        return;
+
+    // a few ranges per thread, so the stealing can even out ranges that take longer
+    const int count = end - begin;
+    const int ranges = (getThreadCount() + 1) * 4;
+    const int step = std::max<int>(std::max<int>(grain, 1), (count + ranges - 1) / ranges);
+
+    const AsyncTaskGroupPtr group = createTaskGroup();
+    for(int from = begin; from < end; from += step) {
+        const int to = std::min<int>(from + step, end);
+        group->run([&func, from, to] { func(from, to); });
+    }
+    group->wait();
+}
+
+bool AsyncDispatcher::runGroupTask(AsyncTaskGroup* group)
+{
+    std::function<void()> task;
+    for(const auto& worker : m_workers) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        const auto it = std::find_if(worker->tasks.begin(), worker->tasks.end(), [group](const Task& t) { return t.group == group; });
+        if(it != worker->tasks.end()) {
+            task = std::move(it->func);
+            worker->tasks.erase(it);
+            --m_pendingTasks;
+            --group->m_queued;
+            break;
+        }
+    }
+
+    if(!task)
+        return false;
+
+    task();
+    return true;
+}
+
+void AsyncDispatcher::exec_loop(int index)
+{
+    t_workerIndex = index;
+
+    std::function<void()> task;
     while(true) {
-        while(m_tasks.empty() && m_running)
-            m_condition.wait(lock);
+        if(popTask(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
 
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this] { return !m_running || m_pendingTasks > 0; });
         if(!m_running)
             return;
+    }
+}
+
+bool AsyncDispatcher::popTask(int index, std::function<void()>& task)
+{
+    const int workers = m_workers.size();
+
+    // own queue first in order, then steal the newest task of another worker
+    if(index >= 0) {
+        Worker& worker = *m_workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if(!worker.tasks.empty()) {
+            Task& front = worker.tasks.front();
+            if(front.group)
+                --front.group->m_queued;
+            task = std::move(front.func);
+            worker.tasks.pop_front();
+            --m_pendingTasks;
+            return true;
+        }
+    }
+
+    for(int i = 1; i <= workers; ++i) {
+        const int victim = (std::max<int>(index, 0) + i) % workers;
+        if(victim == index)
+            continue;
+
+        Worker& worker = *m_workers[victim];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if(!worker.tasks.empty()) {
+            Task& back = worker.tasks.back();
+            if(back.group)
+                --back.group->m_queued;
+            task = std::move(back.func);
+            worker.tasks.pop_back();
+            --m_pendingTasks;
+            return true;
+        }
+    }
 
-        std::function<void()> task = m_tasks.front();
-        m_tasks.pop_front();
+    return false;
+}
+
+void AsyncDispatcher::postContinuation(std::function<void()> continuation)
+{
+    std::lock_guard<std::mutex> lock(m_continuationsMutex);
+    m_continuations.push_back(std::move(continuation));
+}
 
-        lock.unlock();
+void AsyncTaskGroup::run(const std::function<void()>& task)
+{
+    ++m_pending;
+    const AsyncTaskGroupPtr self = shared_from_this();
+    g_asyncDispatcher.push([self, task] {
         task();
-        lock.lock();
+        self->finish();
+    }, this);
+
+    // a waiting thread may take the new task over
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_condition.notify_all();
+}
+
+void AsyncTaskGroup::then(const std::function<void()>& continuation)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_pending == 0)
+        g_asyncDispatcher.postContinuation(continuation);
+    else
+        m_continuation = continuation;
+}
+
+void AsyncTaskGroup::wait()
+{
+    while(m_pending > 0) {
+        if(g_asyncDispatcher.runGroupTask(this))
+            continue;
+
+        // the remaining tasks are running on the workers
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this] { return m_pending == 0 || m_queued > 0; });
+    }
+}
+
+void AsyncTaskGroup::finish()
+{
+    if(--m_pending > 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_condition.notify_all();
+    if(m_continuation) {
+        g_asyncDispatcher.postContinuation(std::move(m_continuation));
+        m_continuation = nullptr;
     }
 }
@@ -26,33 +26,106 @@
 #include "declarations.h"
 #include <framework/stdext/thread.h>
 
+#include <atomic>
+#include <deque>
+
+ /**
+  * Group of tasks running on g_asyncDispatcher, the continuation runs on the main thread once all of them finished.
+  * Every task of the group must be added before setting the continuation.
+  */
+class AsyncTaskGroup : public std::enable_shared_from_this<AsyncTaskGroup>
+{
+public:
+    void run(const std::function<void()>& task);
+    void then(const std::function<void()>& continuation);
+
+    // the calling thread runs the queued tasks of the group while it waits, it never picks other tasks
+    void wait();
+
+    bool isDone() { return m_pending == 0; }
+
+private:
+    void finish();
+
+    std::atomic<int> m_pending{ 0 };
+    // tasks still sitting in a worker queue
+    std::atomic<int> m_queued{ 0 };
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::function<void()> m_continuation;
+
+    friend class AsyncDispatcher;
+};
+
+using AsyncTaskGroupPtr = std::shared_ptr<AsyncTaskGroup>;
+
+ /**
+  * Pool of worker threads, each one with its own task queue. Idle workers steal tasks from the
+  * queues of the busy ones, so a burst of tasks spreads over every core.
+  */
 class AsyncDispatcher {
+    enum {
+        MAX_THREADS = 16
+    };
+
 public:
     void init();
     void terminate();
 
-    void spawn_thread();
-    void stop();
+    // main thread, hands finished task group continuations over to g_dispatcher
+    void poll();
 
     template<class F>
     boost::shared_future<typename std::result_of<F()>::type> schedule(const F& task)
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
         auto prom = std::make_shared<boost::promise<typename std::result_of<F()>::type>>();
-        m_tasks.push_back([=]() { prom->set_value(task()); });
-        m_condition.notify_all();
+        dispatch([=]() { prom->set_value(task()); });
         return boost::shared_future<typename std::result_of<F()>::type>(prom->get_future());
     }
 
+    void dispatch(std::function<void()> task);
+
+    AsyncTaskGroupPtr createTaskGroup() { return std::make_shared<AsyncTaskGroup>(); }
+
+    // runs func over [begin, end) split in ranges of at least grain items, returns when all ranges are done
+    void parallelFor(int begin, int end, const std::function<void(int, int)>& func, int grain = 1);
+
+    int getThreadCount() { return m_workers.size(); }
+
 protected:
-    void exec_loop();
+    void exec_loop(int index);
 
 private:
-    std::list<std::function<void()>> m_tasks;
-    std::list<std::thread> m_threads;
+    struct Task
+    {
+        std::function<void()> func;
+        AsyncTaskGroup* group;
+    };
+
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    void push(std::function<void()> task, AsyncTaskGroup* group);
+    bool popTask(int index, std::function<void()>& task);
+    // runs a single queued task of the group on the calling thread
+    bool runGroupTask(AsyncTaskGroup* group);
+    void postContinuation(std::function<void()> continuation);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<uint32> m_nextWorker{ 0 };
+    std::atomic<int> m_pendingTasks{ 0 };
     std::mutex m_mutex;
     std::condition_variable m_condition;
     bool m_running{ false };
+
+    std::mutex m_continuationsMutex;
+    std::vector<std::function<void()>> m_continuations;
+
+    friend class AsyncTaskGroup;
 };
 
 extern AsyncDispatcher g_asyncDispatcher;
@@ -27,57 +27,90 @@
 #include "framework/stdext/math.h"
 
 BinaryTree::BinaryTree(const FileStreamPtr& fin) :
-    m_fin(fin), m_pos(0xFFFFFFFF)
+    m_index(new Index), m_node(0), m_buffer(0), m_pos(0xFFFFFFFF)
 {
-    m_startPos = fin->tell();
-}
+    const uint8* data = fin->cachedData();
+    const uint size = fin->size();
+    uint pos = fin->tell();
 
-BinaryTree::~BinaryTree()
-= default;
+    m_index->fin = fin;
+    m_index->data = data;
 
-void BinaryTree::skipNodes()
-{
-    while(true) {
-        const uint8 byte = m_fin->getU8();
-        switch(byte) {
+    auto& nodes = m_index->nodes;
+    nodes.push_back({ pos, 0, 0, 0 });
+
+    // open nodes and the last child seen for each of them
+    std::vector<std::pair<uint32, uint32>> stack;
+    stack.emplace_back(0, 0);
+    while(!stack.empty()) {
+        if(pos >= size)
+            stdext::throw_exception("BinaryTree: unexpected end of file");
+
+        switch(data[pos++]) {
         case BINARYTREE_NODE_START:
         {
-            skipNodes();
+            const uint32 index = nodes.size();
+            nodes.push_back({ pos, 0, 0, 0 });
+
+            auto& parent = stack.back();
+            if(parent.second != 0)
+                nodes[parent.second].nextSibling = index;
+            else
+                nodes[parent.first].firstChild = index;
+            parent.second = index;
+
+            stack.emplace_back(index, 0);
             break;
         }
         case BINARYTREE_NODE_END:
-            return;
+            nodes[stack.back().first].end = pos - 1;
+            stack.pop_back();
+            break;
         case BINARYTREE_ESCAPE_CHAR:
-            m_fin->getU8();
+            ++pos;
             break;
         default:
             break;
         }
     }
+
+    fin->seek(pos);
 }
 
+BinaryTree::BinaryTree(IndexPtr index, uint32 node) :
+    m_index(std::move(index)), m_node(node), m_buffer(0), m_pos(0xFFFFFFFF)
+{
+}
+
+BinaryTree::~BinaryTree()
+= default;
+
 void BinaryTree::unserialize()
 {
     if(m_pos != 0xFFFFFFFF)
         return;
     m_pos = 0;
 
-    m_fin->seek(m_startPos);
-    while(true) {
-        uint8 byte = m_fin->getU8();
-        switch(byte) {
+    const auto& nodes = m_index->nodes;
+    const Node& node = nodes[m_node];
+    const uint8* data = m_index->data;
+
+    m_buffer.reserve(node.end - node.begin);
+
+    uint32 child = node.firstChild;
+    for(uint32 pos = node.begin; pos < node.end;) {
+        switch(data[pos]) {
         case BINARYTREE_NODE_START:
-        {
-            skipNodes();
+            // children are not part of the properties
+            pos = nodes[child].end + 1;
+            child = nodes[child].nextSibling;
             break;
-        }
-        case BINARYTREE_NODE_END:
-            return;
         case BINARYTREE_ESCAPE_CHAR:
-            m_buffer.add(m_fin->getU8());
+            m_buffer.add(data[pos + 1]);
+            pos += 2;
             break;
         default:
-            m_buffer.add(byte);
+            m_buffer.add(data[pos++]);
             break;
         }
     }
@@ -85,27 +118,18 @@ void BinaryTree::unserialize()
 
 BinaryTreeVec BinaryTree::getChildren()
 {
+    const auto& nodes = m_index->nodes;
+
     BinaryTreeVec children;
-    m_fin->seek(m_startPos);
-    while(true) {
-        const uint8 byte = m_fin->getU8();
-        switch(byte) {
-        case BINARYTREE_NODE_START:
-        {
-            BinaryTreePtr node(new BinaryTree(m_fin));
-            children.push_back(node);
-            node->skipNodes();
-            break;
-        }
-        case BINARYTREE_NODE_END:
-            return children;
-        case BINARYTREE_ESCAPE_CHAR:
-            m_fin->getU8();
-            break;
-        default:
-            break;
-        }
-    }
+    for(uint32 child = nodes[m_node].firstChild; child != 0; child = nodes[child].nextSibling)
+        children.push_back(BinaryTreePtr(new BinaryTree(m_index, child)));
+    return children;
+}
+
+std::string BinaryTree::getRawData()
+{
+    const Node& node = m_index->nodes[m_node];
+    return std::string(reinterpret_cast<const char*>(m_index->data) + node.begin - 1, node.end - node.begin + 2);
 }
 
 void BinaryTree::seek(uint pos)
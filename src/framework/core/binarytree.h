@@ -35,6 +35,7 @@ enum {
 class BinaryTree : public stdext::shared_object
 {
 public:
+    // indexes the whole tree in one pass, the stream must be right after the root node start
     BinaryTree(const FileStreamPtr& fin);
     ~BinaryTree() override;
 
@@ -53,14 +54,38 @@ public:
     BinaryTreeVec getChildren();
     bool canRead() { unserialize(); return m_pos < m_buffer.size(); }
 
+    // the node and its children as stored, to be parsed apart on its own stream
+    std::string getRawData();
+
 private:
+    struct Node
+    {
+        // escaped bytes between the node start and end markers, children included
+        uint32 begin;
+        uint32 end;
+        // node indexes, 0 means none since the root is never a child
+        uint32 firstChild;
+        uint32 nextSibling;
+    };
+
+    struct Index : public stdext::shared_object
+    {
+        // owns the cached file data the nodes point into
+        FileStreamPtr fin;
+        const uint8* data;
+        std::vector<Node> nodes;
+    };
+    using IndexPtr = stdext::shared_object_ptr<Index>;
+
+    BinaryTree(IndexPtr index, uint32 node);
+
+    // unescapes the node properties on first read
     void unserialize();
-    void skipNodes();
 
-    FileStreamPtr m_fin;
+    IndexPtr m_index;
+    uint32 m_node;
     DataBuffer<uint8> m_buffer;
     uint m_pos;
-    uint m_startPos;
 };
 
 class OutputBinaryTree : public stdext::shared_object
@@ -23,6 +23,7 @@
 
 #include "consoleapplication.h"
 #include <framework/core/clock.h>
+#include <framework/core/framearena.h>
 #include <framework/luaengine/luainterface.h>
 
 #ifdef FW_NET
@@ -44,6 +45,7 @@ void ConsoleApplication::run()
     g_lua.callGlobalField("g_app", "onRun");
 
     while(!m_stopping) {
+        g_frameArena.reset();
         poll();
         stdext::millisleep(1);
         g_clock.update();
@@ -32,6 +32,7 @@ class Module;
 class Config;
 class Event;
 class ScheduledEvent;
+class TimerWheel;
 class FileStream;
 class BinaryTree;
 class OutputBinaryTree;
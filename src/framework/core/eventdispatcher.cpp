@@ -24,6 +24,7 @@
 
 #include <framework/core/clock.h>
 #include "timer.h"
+#include <framework/stdext/time.h>
 
 EventDispatcher g_dispatcher;
 
@@ -32,26 +33,14 @@ void EventDispatcher::shutdown()
     while(!m_eventList.empty())
         poll();
 
-    while(!m_scheduledEventList.empty()) {
-        ScheduledEventPtr scheduledEvent = m_scheduledEventList.top();
-        scheduledEvent->cancel();
-        m_scheduledEventList.pop();
-    }
+    m_scheduledEvents.cancelAll();
     m_disabled = true;
 }
 
 void EventDispatcher::poll()
 {
-    for(int count = 0, max = m_scheduledEventList.size(); count < max && !m_scheduledEventList.empty(); ++count) {
-        ScheduledEventPtr scheduledEvent = m_scheduledEventList.top();
-        if(scheduledEvent->remainingTicks() > 0)
-            break;
-        m_scheduledEventList.pop();
-        scheduledEvent->execute();
-
-        if(scheduledEvent->nextCycle())
-            m_scheduledEventList.push(scheduledEvent);
-    }
+    const ticks_t startTime = stdext::micros();
+    uint32 executed = m_scheduledEvents.advance(g_clock.millis());
 
     // execute events list until all events are out, this is needed because some events can schedule new events that would
     // change the UIWidgets layout, in this case we must execute these new events before we continue rendering,
@@ -72,10 +61,14 @@ void EventDispatcher::poll()
             m_eventList.pop_front();
             event->execute();
         }
+        executed += m_pollEventsSize;
         m_pollEventsSize = m_eventList.size();
 
         loops++;
     }
+
+    m_pollEventCount = executed;
+    m_pollTime = stdext::micros() - startTime;
 }
 
 ScheduledEventPtr EventDispatcher::scheduleEvent(const std::function<void()>& callback, int delay)
@@ -85,7 +78,7 @@ ScheduledEventPtr EventDispatcher::scheduleEvent(const std::function<void()>& ca
 
     assert(delay >= 0);
     ScheduledEventPtr scheduledEvent(new ScheduledEvent(callback, delay, 1));
-    m_scheduledEventList.push(scheduledEvent);
+    m_scheduledEvents.add(scheduledEvent);
     return scheduledEvent;
 }
 
@@ -96,7 +89,7 @@ ScheduledEventPtr EventDispatcher::cycleEvent(const std::function<void()>& callb
 
     assert(delay > 0);
     ScheduledEventPtr scheduledEvent(new ScheduledEvent(callback, delay, 0));
-    m_scheduledEventList.push(scheduledEvent);
+    m_scheduledEvents.add(scheduledEvent);
     return scheduledEvent;
 }
 
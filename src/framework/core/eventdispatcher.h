@@ -25,8 +25,7 @@
 
 #include "clock.h"
 #include "scheduledevent.h"
-
-#include <queue>
+#include "timerwheel.h"
 
  // @bindsingleton g_dispatcher
 class EventDispatcher
@@ -39,11 +38,19 @@ public:
     ScheduledEventPtr scheduleEvent(const std::function<void()>& callback, int delay);
     ScheduledEventPtr cycleEvent(const std::function<void()>& callback, int delay);
 
+    // stats of the last poll, time in microseconds
+    uint32 getPollEventCount() { return m_pollEventCount; }
+    uint32 getPollTime() { return m_pollTime; }
+    uint32 getScheduledEventCount() { return m_scheduledEvents.size(); }
+
 private:
     std::deque<EventPtr> m_eventList;
     int m_pollEventsSize;
     bool m_disabled{ false };
-    std::priority_queue<ScheduledEventPtr, std::deque<ScheduledEventPtr>, ScheduledEvent::Compare> m_scheduledEventList;
+    TimerWheel m_scheduledEvents;
+
+    uint32 m_pollEventCount{ 0 };
+    uint32 m_pollTime{ 0 };
 };
 
 extern EventDispatcher g_dispatcher;
@@ -333,6 +333,10 @@ std::string FileStream::getString()
 
 BinaryTreePtr FileStream::getBinaryTree()
 {
+    // the tree is indexed straight from the cached data
+    if(!m_caching)
+        cache();
+
     const uint8 byte = getU8();
     if(byte != BINARYTREE_NODE_START)
         stdext::throw_exception(stdext::format("failed to read node start (getBinaryTree): %d", byte));
@@ -50,6 +50,9 @@ public:
     bool eof();
     std::string name() { return m_name; }
 
+    // contents of a cached stream, stable until the stream is written or destroyed
+    const uint8* cachedData() { return m_data.data(); }
+
     uint8 getU8();
     uint16 getU16();
     uint32 getU32();
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "framearena.h"
+
+FrameArena g_frameArena;
+
+FrameArena::FrameArena() : m_buffer(INITIAL_BUFFER_SIZE)
+{
+    m_resource.emplace(m_buffer.data(), m_buffer.size(), std::pmr::new_delete_resource());
+}
+
+void FrameArena::reset()
+{
+    m_lastFrameAllocations = m_allocations;
+    m_lastFrameBytes = m_bytes;
+
+    // grow the initial buffer when a frame didn't fit, so the next frames don't hit the heap
+    if(m_bytes > m_buffer.size()) {
+        m_resource.reset();
+        m_buffer = std::vector<uint8>(stdext::to_power_of_two(m_bytes));
+        m_resource.emplace(m_buffer.data(), m_buffer.size(), std::pmr::new_delete_resource());
+    } else
+        m_resource->release();
+
+    m_allocations = 0;
+    m_bytes = 0;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+    ++m_allocations;
+    m_bytes += bytes + alignment - 1;
+    return m_resource->allocate(bytes, alignment);
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <framework/global.h>
+#include <memory_resource>
+#include <optional>
+
+ /**
+  * Memory resource for temporaries that never outlive the current frame,
+  * allocations are bump allocated and all released at once when the main loop resets it.
+  * It is not thread safe, only the main thread may use it.
+  */
+class FrameArena : public std::pmr::memory_resource
+{
+public:
+    enum {
+        INITIAL_BUFFER_SIZE = 256 * 1024
+    };
+
+    FrameArena();
+
+    // called once per main loop iteration, nothing allocated before may be in use anymore
+    void reset();
+
+    uint32 getFrameAllocations() { return m_lastFrameAllocations; }
+    size_t getFrameBytes() { return m_lastFrameBytes; }
+    size_t getBufferSize() { return m_buffer.size(); }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* /*p*/, size_t /*bytes*/, size_t /*alignment*/) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    std::vector<uint8> m_buffer;
+    std::optional<std::pmr::monotonic_buffer_resource> m_resource;
+
+    uint32 m_allocations{ 0 };
+    size_t m_bytes{ 0 };
+
+    uint32 m_lastFrameAllocations{ 0 };
+    size_t m_lastFrameBytes{ 0 };
+};
+
+extern FrameArena g_frameArena;
+
+// containers for per frame temporaries, construct them with &g_frameArena
+template<typename T>
+using FrameVector = std::pmr::vector<T>;
+using FrameString = std::pmr::string;
+
+#endif
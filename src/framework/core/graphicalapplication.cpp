@@ -23,6 +23,7 @@
 #include "graphicalapplication.h"
 #include <framework/core/clock.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/core/framearena.h>
 #include <framework/platform/platformwindow.h>
 #include <framework/ui/uimanager.h>
 #include <framework/graphics/graphics.h>
@@ -126,6 +127,9 @@ void GraphicalApplication::run()
     g_lua.callGlobalField("g_app", "onRun");
 
     while(!m_stopping) {
+        // temporaries of the last iteration are gone by now
+        g_frameArena.reset();
+
         // poll all events before rendering
         poll();
 
@@ -187,6 +191,7 @@ void GraphicalApplication::run()
 
                 // update screen pixels
                 g_window.swapBuffers();
+                g_painter->nextFrame();
             }
 
             // only update the current time once per frame to gain performance
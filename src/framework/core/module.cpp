@@ -38,6 +38,9 @@ bool Module::load()
     if(m_loaded)
         return true;
 
+    // module scripts may replace globals cached by LuaGlobalField
+    g_lua.invalidateGlobalFields();
+
     try {
         // add to package.loaded
         g_lua.getGlobalField("package", "loaded");
@@ -113,6 +116,8 @@ bool Module::load()
 void Module::unload()
 {
     if(m_loaded) {
+        g_lua.invalidateGlobalFields();
+
         try {
             if(m_sandboxed)
                 g_lua.setGlobalEnvironment(m_sandboxEnv);
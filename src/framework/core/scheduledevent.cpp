@@ -21,6 +21,7 @@
  */
 
 #include "scheduledevent.h"
+#include "timerwheel.h"
 
 ScheduledEvent::ScheduledEvent(const std::function<void()>& callback, int delay, int maxCycles) : Event(callback)
 {
@@ -44,6 +45,15 @@ void ScheduledEvent::execute()
     m_cyclesExecuted++;
 }
 
+void ScheduledEvent::cancel()
+{
+    Event::cancel();
+
+    // leave the wheel now instead of waiting to expire, may release the last reference
+    if(m_wheel)
+        m_wheel->remove(this);
+}
+
 bool ScheduledEvent::nextCycle()
 {
     if(m_callback && !m_canceled && (m_maxCycles == 0 || m_cyclesExecuted < m_maxCycles)) {
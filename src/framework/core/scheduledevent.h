@@ -32,6 +32,7 @@ class ScheduledEvent : public Event
 public:
     ScheduledEvent(const std::function<void()>& callback, int delay, int maxCycles);
     void execute() override;
+    void cancel() override;
     bool nextCycle();
 
     int ticks() { return m_ticks; }
@@ -40,18 +41,19 @@ public:
     int cyclesExecuted() { return m_cyclesExecuted; }
     int maxCycles() { return m_maxCycles; }
 
-    struct Compare {
-        bool operator() (const ScheduledEventPtr& a, const ScheduledEventPtr& b) const
-        {
-            return b->ticks() < a->ticks();
-        }
-    };
-
 private:
     ticks_t m_ticks;
     int m_delay;
     int m_maxCycles;
     int m_cyclesExecuted;
+
+    // links of the timer wheel slot holding the event
+    TimerWheel* m_wheel{ nullptr };
+    ScheduledEvent* m_wheelPrev{ nullptr };
+    ScheduledEvent* m_wheelNext{ nullptr };
+    int m_wheelSlot{ -1 };
+
+    friend class TimerWheel;
 };
 
 #endif
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "timerwheel.h"
+#include "scheduledevent.h"
+
+void TimerWheel::add(const ScheduledEventPtr& event)
+{
+    if(m_currentTicks < 0)
+        m_currentTicks = g_clock.millis();
+
+    // the wheel keeps its own reference while the event is linked
+    event->add_ref();
+    event->m_wheel = this;
+    link(getSlot(event->ticks()), event.get());
+    ++m_size;
+}
+
+void TimerWheel::remove(ScheduledEvent* event)
+{
+    if(event->m_wheel != this)
+        return;
+
+    unlink(event);
+}
+
+uint32 TimerWheel::advance(ticks_t now)
+{
+    if(m_size == 0) {
+        // nothing to walk through, jump straight to the present
+        if(now >= m_currentTicks)
+            m_currentTicks = now + 1;
+        return 0;
+    }
+
+    uint32 executed = 0;
+    while(m_currentTicks <= now) {
+        const int index = m_currentTicks & ROOT_MASK;
+
+        // the root level wrapped, bring down the events of the next range
+        if(index == 0) {
+            for(int level = 0; level < LEVELS; ++level) {
+                const int levelIndex = (m_currentTicks >> (ROOT_BITS + level * LEVEL_BITS)) & LEVEL_MASK;
+                cascade(ROOT_SIZE + level * LEVEL_SIZE + levelIndex);
+                if(levelIndex != 0)
+                    break;
+            }
+        }
+
+        // move the due events aside, so the ones scheduled by them can't land in this run
+        Slot& slot = m_slots[index];
+        for(ScheduledEvent* event = slot.head; event; event = event->m_wheelNext)
+            event->m_wheelSlot = EXPIRED_SLOT;
+        m_slots[EXPIRED_SLOT] = slot;
+        slot = Slot();
+
+        ++m_currentTicks;
+
+        while(ScheduledEvent* head = m_slots[EXPIRED_SLOT].head) {
+            const ScheduledEventPtr event = unlink(head);
+            event->execute();
+            ++executed;
+
+            if(event->nextCycle())
+                add(event);
+        }
+    }
+
+    return executed;
+}
+
+void TimerWheel::cancelAll()
+{
+    for(Slot& slot : m_slots) {
+        while(slot.head)
+            unlink(slot.head)->cancel();
+    }
+}
+
+int TimerWheel::getSlot(ticks_t ticks)
+{
+    ticks_t delta = ticks - m_currentTicks;
+
+    // already due, goes to the next slot to be executed
+    if(delta < 0)
+        return m_currentTicks & ROOT_MASK;
+
+    if(delta < ROOT_SIZE)
+        return ticks & ROOT_MASK;
+
+    for(int level = 0; level < LEVELS; ++level) {
+        const int shift = ROOT_BITS + (level + 1) * LEVEL_BITS;
+        const ticks_t range = static_cast<ticks_t>(1) << shift;
+        if(delta >= range) {
+            if(level < LEVELS - 1)
+                continue;
+
+            // beyond the wheel range, parked at its end and placed again when cascaded
+            ticks = m_currentTicks + range - 1;
+        }
+        return ROOT_SIZE + level * LEVEL_SIZE + ((ticks >> (shift - LEVEL_BITS)) & LEVEL_MASK);
+    }
+
+    return m_currentTicks & ROOT_MASK;
+}
+
+void TimerWheel::link(int slot, ScheduledEvent* event)
+{
+    Slot& s = m_slots[slot];
+    event->m_wheelSlot = slot;
+    event->m_wheelPrev = s.tail;
+    event->m_wheelNext = nullptr;
+    if(s.tail)
+        s.tail->m_wheelNext = event;
+    else
+        s.head = event;
+    s.tail = event;
+}
+
+ScheduledEventPtr TimerWheel::unlink(ScheduledEvent* event)
+{
+    Slot& s = m_slots[event->m_wheelSlot];
+    if(event->m_wheelPrev)
+        event->m_wheelPrev->m_wheelNext = event->m_wheelNext;
+    else
+        s.head = event->m_wheelNext;
+    if(event->m_wheelNext)
+        event->m_wheelNext->m_wheelPrev = event->m_wheelPrev;
+    else
+        s.tail = event->m_wheelPrev;
+
+    event->m_wheelPrev = event->m_wheelNext = nullptr;
+    event->m_wheelSlot = -1;
+    event->m_wheel = nullptr;
+    --m_size;
+
+    // hands the wheel reference over to the caller
+    return ScheduledEventPtr(event, false);
+}
+
+void TimerWheel::cascade(int slot)
+{
+    Slot events = m_slots[slot];
+    m_slots[slot] = Slot();
+
+    for(ScheduledEvent* event = events.head; event;) {
+        ScheduledEvent* next = event->m_wheelNext;
+        link(getSlot(event->ticks()), event);
+        event = next;
+    }
+}
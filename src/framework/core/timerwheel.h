@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include "declarations.h"
+
+#include <array>
+
+ /**
+  * Hierarchical timer wheel holding the scheduled events of the dispatcher, with millisecond slots.
+  * The root level has a slot per millisecond of the next 256ms, each upper level covers 64 slots of
+  * the whole range of the level below, events move down a level when the wheel reaches their range.
+  * Adding and removing are constant time, canceled events leave the wheel right away.
+  */
+class TimerWheel
+{
+public:
+    void add(const ScheduledEventPtr& event);
+    void remove(ScheduledEvent* event);
+
+    // executes the events due until now, returns how many were executed
+    uint32 advance(ticks_t now);
+    void cancelAll();
+
+    uint32 size() { return m_size; }
+
+private:
+    enum {
+        ROOT_BITS = 8,
+        LEVEL_BITS = 6,
+        LEVELS = 4,
+        ROOT_SIZE = 1 << ROOT_BITS,
+        LEVEL_SIZE = 1 << LEVEL_BITS,
+        ROOT_MASK = ROOT_SIZE - 1,
+        LEVEL_MASK = LEVEL_SIZE - 1,
+        // due events are moved here while they execute
+        EXPIRED_SLOT = ROOT_SIZE + LEVELS * LEVEL_SIZE,
+        SLOT_COUNT
+    };
+
+    struct Slot
+    {
+        ScheduledEvent* head{ nullptr };
+        ScheduledEvent* tail{ nullptr };
+    };
+
+    int getSlot(ticks_t ticks);
+    void link(int slot, ScheduledEvent* event);
+    ScheduledEventPtr unlink(ScheduledEvent* event);
+    void cascade(int slot);
+
+    std::array<Slot, SLOT_COUNT> m_slots;
+    ticks_t m_currentTicks{ -1 };
+    uint32 m_size{ 0 };
+};
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "drawbatch.h"
+
+void DrawBatch::addQuad(const State& state, const Rect& dest, const Rect& src)
+{
+    if(m_pendingQuads > 0 && m_state != state)
+        flush();
+
+    if(m_pendingQuads == 0)
+        m_state = state;
+
+    // quads are stored as two triangles so neighbours can share one draw call
+    m_coordsBuffer.addRect(dest, src);
+    ++m_pendingQuads;
+    ++m_quads;
+}
+
+void DrawBatch::flush()
+{
+    if(m_pendingQuads == 0)
+        return;
+
+    // reset before calling back, the callback may draw through code that flushes again
+    m_pendingQuads = 0;
+    ++m_batches;
+
+    if(m_flushCallback)
+        m_flushCallback(m_state, m_coordsBuffer);
+
+    m_coordsBuffer.clear();
+    m_state = State();
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DRAWBATCH_H
+#define DRAWBATCH_H
+
+#include "painter.h"
+
+// Records textured quads and merges consecutive quads drawn with the same state
+// into a single coords buffer. Whenever the state changes or flush() is called the
+// pending quads are handed to the flush callback as one batch, the painter uses it
+// to issue a single draw call while a recording callback can count batches without gl.
+class DrawBatch
+{
+public:
+    struct State {
+        TexturePtr texture;
+        PainterShaderProgram* shaderProgram{ nullptr };
+        Color color;
+        float opacity{ 1.0f };
+        Painter::CompositionMode compositionMode{ Painter::CompositionMode_Normal };
+        Rect clipRect;
+
+        bool operator==(const State& other) const {
+            return texture == other.texture && shaderProgram == other.shaderProgram && color == other.color &&
+                opacity == other.opacity && compositionMode == other.compositionMode && clipRect == other.clipRect;
+        }
+        bool operator!=(const State& other) const { return !(*this == other); }
+    };
+
+    using FlushCallback = std::function<void(const State& state, CoordsBuffer& coordsBuffer)>;
+
+    void setFlushCallback(const FlushCallback& callback) { m_flushCallback = callback; }
+
+    void addQuad(const State& state, const Rect& dest, const Rect& src);
+    void flush();
+
+    bool isEmpty() { return m_pendingQuads == 0; }
+    uint32 getPendingQuads() { return m_pendingQuads; }
+    uint32 getQuadCount() { return m_quads; }
+    uint32 getBatchCount() { return m_batches; }
+    void resetCounters() { m_quads = 0; m_batches = 0; }
+
+private:
+    FlushCallback m_flushCallback;
+    State m_state;
+    CoordsBuffer m_coordsBuffer;
+    uint32 m_pendingQuads{ 0 };
+    uint32 m_quads{ 0 };
+    uint32 m_batches{ 0 };
+};
+
+#endif
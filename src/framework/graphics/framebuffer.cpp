@@ -98,6 +98,8 @@ void FrameBuffer::resize(const Size& size)
 
 void FrameBuffer::bind(const bool autoClear)
 {
+    // quads batched for the previous target must be drawn before switching
+    g_painter->flushBatch();
     g_painter->saveAndResetState();
     internalBind();
     g_painter->setResolution(m_texture->getSize());
@@ -109,6 +111,7 @@ void FrameBuffer::bind(const bool autoClear)
 
 void FrameBuffer::release()
 {
+    g_painter->flushBatch();
     internalRelease();
     g_painter->restoreSavedState();
 
@@ -53,6 +53,10 @@ public:
     void resize(const Size& size);
 
     int getMaxTextureSize() { return m_maxTextureSize; }
+    uint32 getTextureBinds() { return g_painter->getLastFrameStats().textureBinds; }
+    uint32 getDrawCalls() { return g_painter->getLastFrameStats().drawCalls; }
+    uint32 getDrawBatches() { return g_painter->getLastFrameStats().batches; }
+    uint32 getBatchedQuads() { return g_painter->getLastFrameStats().batchedQuads; }
     const Size& getViewportSize() { return m_viewportSize; }
 
     std::string getVendor() { return (const char*)glGetString(GL_VENDOR); }
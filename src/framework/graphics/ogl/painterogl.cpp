@@ -36,6 +36,12 @@ PainterOGL::PainterOGL()
     m_texture = nullptr;
     m_alphaWriting = false;
     setResolution(g_window.getSize());
+
+    // the painter state always matches the pending batch, setters flush before changing it
+    m_drawBatch.setFlushCallback([this](const DrawBatch::State&, CoordsBuffer& coordsBuffer) {
+        ++m_frameStats.batches;
+        drawCoords(coordsBuffer, Triangles);
+    });
 }
 
 void PainterOGL::resetState()
@@ -104,12 +110,14 @@ void PainterOGL::restoreSavedState()
 
 void PainterOGL::clear(const Color& color)
 {
+    flushBatch();
     glClearColor(color.rF(), color.gF(), color.bF(), color.aF());
     glClear(GL_COLOR_BUFFER_BIT);
 }
 
 void PainterOGL::clearRect(const Color& color, const Rect& rect)
 {
+    flushBatch();
     const Rect oldClipRect = m_clipRect;
     setClipRect(rect);
     glClearColor(color.rF(), color.gF(), color.bF(), color.aF());
@@ -121,6 +129,7 @@ void PainterOGL::setCompositionMode(CompositionMode compositionMode)
 {
     if(m_compositionMode == compositionMode)
         return;
+    flushBatch();
     m_compositionMode = compositionMode;
     updateGlCompositionMode();
 }
@@ -129,6 +138,7 @@ void PainterOGL::setBlendEquation(BlendEquation blendEquation)
 {
     if(m_blendEquation == blendEquation)
         return;
+    flushBatch();
     m_blendEquation = blendEquation;
     updateGlBlendEquation();
 }
@@ -137,6 +147,7 @@ void PainterOGL::setClipRect(const Rect& clipRect)
 {
     if(m_clipRect == clipRect)
         return;
+    flushBatch();
     m_clipRect = clipRect;
     updateGlClipRect();
 }
@@ -146,6 +157,7 @@ void PainterOGL::setTexture(Texture* texture)
     if(m_texture == texture)
         return;
 
+    flushBatch();
     m_texture = texture;
 
     uint glTextureId;
@@ -158,6 +170,7 @@ void PainterOGL::setTexture(Texture* texture)
     if(m_glTextureId != glTextureId) {
         m_glTextureId = glTextureId;
         updateGlTexture();
+        ++m_frameStats.textureBinds;
     }
 }
 
@@ -166,10 +179,38 @@ void PainterOGL::setAlphaWriting(bool enable)
     if(m_alphaWriting == enable)
         return;
 
+    flushBatch();
     m_alphaWriting = enable;
     updateGlAlphaWriting();
 }
 
+void PainterOGL::setShaderProgram(PainterShaderProgram* shaderProgram)
+{
+    if(m_shaderProgram == shaderProgram)
+        return;
+
+    flushBatch();
+    m_shaderProgram = shaderProgram;
+}
+
+void PainterOGL::setColor(const Color& color)
+{
+    if(m_color == color)
+        return;
+
+    flushBatch();
+    m_color = color;
+}
+
+void PainterOGL::setOpacity(float opacity)
+{
+    if(m_opacity == opacity)
+        return;
+
+    flushBatch();
+    m_opacity = opacity;
+}
+
 void PainterOGL::setResolution(const Size& resolution)
 {
     // The projection matrix converts from Painter's coordinate system to GL's coordinate system
@@ -189,6 +230,7 @@ void PainterOGL::setResolution(const Size& resolution)
                                  0.0f,                    -2.0f / resolution.height(),  0.0f,
                                 -1.0f,                     1.0f,                      1.0f };
 
+    flushBatch();
     m_resolution = resolution;
 
     setProjectionMatrix(projectionMatrix);
@@ -249,6 +291,27 @@ void PainterOGL::popTransformMatrix()
     m_transformMatrixStack.pop_back();
 }
 
+void PainterOGL::endBatch()
+{
+    assert(m_batchDepth > 0);
+    if(--m_batchDepth == 0)
+        flushBatch();
+}
+
+void PainterOGL::addBatchQuad(const Rect& dest, const TexturePtr& texture, const Rect& src, PainterShaderProgram* shaderProgram)
+{
+    DrawBatch::State state;
+    state.texture = texture;
+    state.shaderProgram = shaderProgram;
+    state.color = m_color;
+    state.opacity = m_opacity;
+    state.compositionMode = m_compositionMode;
+    state.clipRect = m_clipRect;
+
+    m_drawBatch.addQuad(state, dest, src);
+    ++m_frameStats.batchedQuads;
+}
+
 void PainterOGL::updateGlTexture()
 {
     if(m_glTextureId != 0)
@@ -24,6 +24,7 @@
 #define PAINTEROGL_H
 
 #include <framework/graphics/painter.h>
+#include <framework/graphics/drawbatch.h>
 
 class PainterOGL : public Painter
 {
@@ -47,7 +48,7 @@ public:
     ~PainterOGL() override = default;
 
     void bind() override { refreshState(); }
-    void unbind() override {}
+    void unbind() override { flushBatch(); }
 
     void resetState();
     virtual void refreshState();
@@ -58,13 +59,15 @@ public:
     void clear(const Color& color) override;
     void clearRect(const Color& color, const Rect& rect);
 
-    virtual void setTransformMatrix(const Matrix3& transformMatrix) { m_transformMatrix = transformMatrix; }
-    virtual void setProjectionMatrix(const Matrix3& projectionMatrix) { m_projectionMatrix = projectionMatrix; }
-    virtual void setTextureMatrix(const Matrix3& textureMatrix) { m_textureMatrix = textureMatrix; }
+    virtual void setTransformMatrix(const Matrix3& transformMatrix) { flushBatch(); m_transformMatrix = transformMatrix; }
+    virtual void setProjectionMatrix(const Matrix3& projectionMatrix) { flushBatch(); m_projectionMatrix = projectionMatrix; }
+    virtual void setTextureMatrix(const Matrix3& textureMatrix) { flushBatch(); m_textureMatrix = textureMatrix; }
     void setCompositionMode(CompositionMode compositionMode) override;
     void setBlendEquation(BlendEquation blendEquation) override;
     void setClipRect(const Rect& clipRect) override;
-    void setShaderProgram(PainterShaderProgram* shaderProgram) override { m_shaderProgram = shaderProgram; }
+    void setShaderProgram(PainterShaderProgram* shaderProgram) override;
+    void setColor(const Color& color) override;
+    void setOpacity(float opacity) override;
     void setTexture(Texture* texture) override;
     void setAlphaWriting(bool enable) override;
 
@@ -79,6 +82,11 @@ public:
     void pushTransformMatrix() override;
     void popTransformMatrix() override;
 
+    void beginBatch() override { ++m_batchDepth; }
+    void endBatch() override;
+    void flushBatch() override { m_drawBatch.flush(); }
+    bool isBatching() { return m_batchDepth > 0; }
+
     Matrix3 getTransformMatrix() { return m_transformMatrix; }
     Matrix3 getProjectionMatrix() { return m_projectionMatrix; }
     Matrix3 getTextureMatrix() { return m_textureMatrix; }
@@ -99,7 +107,11 @@ protected:
     void updateGlAlphaWriting();
     void updateGlViewport();
 
+    void addBatchQuad(const Rect& dest, const TexturePtr& texture, const Rect& src, PainterShaderProgram* shaderProgram);
+
     CoordsBuffer m_coordsBuffer;
+    DrawBatch m_drawBatch;
+    int m_batchDepth{ 0 };
 
     std::vector<Matrix3> m_transformMatrixStack;
     Matrix3 m_transformMatrix;
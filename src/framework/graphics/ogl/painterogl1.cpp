@@ -56,12 +56,16 @@ void PainterOGL1::bind()
 
 void PainterOGL1::unbind()
 {
+    PainterOGL::unbind();
     if(g_graphics.canUseDrawArrays())
         glDisableClientState(GL_VERTEX_ARRAY);
 }
 
 void PainterOGL1::drawCoords(CoordsBuffer& coordsBuffer, DrawMode drawMode)
 {
+    // pending batched quads must reach the screen before anything drawn after them
+    flushBatch();
+
     const int vertexCount = coordsBuffer.getVertexCount();
     if(vertexCount == 0)
         return;
@@ -81,6 +85,8 @@ void PainterOGL1::drawCoords(CoordsBuffer& coordsBuffer, DrawMode drawMode)
     if(g_graphics.hasScissorBug())
         updateGlClipRect();
 
+    ++m_frameStats.drawCalls;
+
     // use vertex arrays if possible, much faster
     if(g_graphics.canUseDrawArrays()) {
         // update coords buffer hardware caches if enabled
@@ -157,6 +163,11 @@ void PainterOGL1::drawTexturedRect(const Rect& dest, const TexturePtr& texture,
 
     setTexture(texture.get());
 
+    if(isBatching()) {
+        addBatchQuad(dest, texture, src, nullptr);
+        return;
+    }
+
     m_coordsBuffer.clear();
     m_coordsBuffer.addQuad(dest, src);
     drawCoords(m_coordsBuffer, TriangleStrip);
@@ -233,6 +244,7 @@ void PainterOGL1::setMatrixMode(MatrixMode matrixMode)
 
 void PainterOGL1::setTransformMatrix(const Matrix3& transformMatrix)
 {
+    flushBatch();
     m_transformMatrix = transformMatrix;
     if(g_painter == this)
         updateGlTransformMatrix();
@@ -240,6 +252,7 @@ void PainterOGL1::setTransformMatrix(const Matrix3& transformMatrix)
 
 void PainterOGL1::setProjectionMatrix(const Matrix3& projectionMatrix)
 {
+    flushBatch();
     m_projectionMatrix = projectionMatrix;
     if(g_painter == this)
         updateGlProjectionMatrix();
@@ -250,6 +263,7 @@ void PainterOGL1::setTextureMatrix(const Matrix3& textureMatrix)
     // avoid re-updating texture matrix
     if(m_textureMatrix == textureMatrix)
         return;
+    flushBatch();
     m_textureMatrix = textureMatrix;
     updateGlTextureMatrix();
 }
@@ -258,6 +272,7 @@ void PainterOGL1::setColor(const Color& color)
 {
     if(m_color == color)
         return;
+    flushBatch();
     m_color = color;
     updateGlColor();
 }
@@ -266,6 +281,7 @@ void PainterOGL1::setOpacity(float opacity)
 {
     if(m_opacity == opacity)
         return;
+    flushBatch();
     m_opacity = opacity;
     updateGlColor();
 }
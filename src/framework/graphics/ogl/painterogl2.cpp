@@ -58,6 +58,7 @@ void PainterOGL2::bind()
 
 void PainterOGL2::unbind()
 {
+    PainterOGL::unbind();
     PainterShaderProgram::disableAttributeArray(PainterShaderProgram::VERTEX_ATTR);
     PainterShaderProgram::disableAttributeArray(PainterShaderProgram::TEXCOORD_ATTR);
     PainterShaderProgram::release();
@@ -65,6 +66,9 @@ void PainterOGL2::unbind()
 
 void PainterOGL2::drawCoords(CoordsBuffer& coordsBuffer, DrawMode drawMode)
 {
+    // pending batched quads must reach the screen before anything drawn after them
+    flushBatch();
+
     const int vertexCount = coordsBuffer.getVertexCount();
     if(vertexCount == 0)
         return;
@@ -75,6 +79,8 @@ void PainterOGL2::drawCoords(CoordsBuffer& coordsBuffer, DrawMode drawMode)
     if(textured && m_texture->isEmpty())
         return;
 
+    ++m_frameStats.drawCalls;
+
     // update shader with the current painter state
     m_drawProgram->bind();
     m_drawProgram->setTransformMatrix(m_transformMatrix);
@@ -145,6 +151,11 @@ void PainterOGL2::drawTexturedRect(const Rect& dest, const TexturePtr& texture,
     setDrawProgram(m_shaderProgram ? m_shaderProgram : m_drawTexturedProgram.get());
     setTexture(texture);
 
+    if(isBatching()) {
+        addBatchQuad(dest, texture, src, m_drawProgram);
+        return;
+    }
+
     m_coordsBuffer.clear();
     m_coordsBuffer.addQuad(dest, src);
     drawCoords(m_coordsBuffer, TriangleStrip);
@@ -50,7 +50,12 @@ public:
     void drawFilledTriangle(const Point& a, const Point& b, const Point& c) override;
     void drawBoundingRect(const Rect& dest, int innerLineWidth = 1) override;
 
-    void setDrawProgram(PainterShaderProgram* drawProgram) { m_drawProgram = drawProgram; }
+    void setDrawProgram(PainterShaderProgram* drawProgram) {
+        if(m_drawProgram == drawProgram)
+            return;
+        flushBatch();
+        m_drawProgram = drawProgram;
+    }
 
     bool hasShaders() override { return true; }
 
@@ -51,6 +51,13 @@ public:
         TriangleStrip = GL_TRIANGLE_STRIP
     };
 
+    struct FrameStats {
+        uint32 textureBinds{ 0 };
+        uint32 drawCalls{ 0 };
+        uint32 batches{ 0 };
+        uint32 batchedQuads{ 0 };
+    };
+
     Painter();
     virtual ~Painter() = default;
 
@@ -112,7 +119,21 @@ public:
 
     virtual bool hasShaders() = 0;
 
+    // textured rects drawn between beginBatch and endBatch are merged into batches,
+    // any painter state change flushes the pending batch so the draw order is kept
+    virtual void beginBatch() {}
+    virtual void endBatch() {}
+    virtual void flushBatch() {}
+
+    void nextFrame() { ++m_frameCount; m_lastFrameStats = m_frameStats; m_frameStats = FrameStats(); }
+    uint32 getFrameCount() { return m_frameCount; }
+    const FrameStats& getLastFrameStats() { return m_lastFrameStats; }
+
 protected:
+    FrameStats m_frameStats;
+    FrameStats m_lastFrameStats;
+    uint32 m_frameCount{ 0 };
+
     PainterShaderProgram* m_shaderProgram;
     CompositionMode m_compositionMode;
     Color m_color;
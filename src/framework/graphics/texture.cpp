@@ -99,6 +99,42 @@ void Texture::uploadPixels(const ImagePtr& image, bool buildMipmaps, bool compre
     m_opaque = !image->hasTransparentPixel();
 }
 
+void Texture::uploadSubImage(const Point& dest, const ImagePtr& image)
+{
+    if(m_id == 0 || image->getBpp() != 4)
+        return;
+
+    bind();
+    glTexSubImage2D(GL_TEXTURE_2D, 0, dest.x, dest.y, image->getWidth(), image->getHeight(), GL_RGBA, GL_UNSIGNED_BYTE, image->getPixelData());
+}
+
+bool Texture::updateRegion(const Rect& region, const uint8* pixels)
+{
+    if(m_id == 0 || !region.isValid() || !Rect(0, 0, m_size).contains(region))
+        return false;
+
+    // software mipmaps would have to be rebuilt from the whole image
+    if(m_hasMipmaps && !g_graphics.canUseHardwareMipmaps())
+        return false;
+
+    bind();
+    glTexSubImage2D(GL_TEXTURE_2D, 0, region.left(), region.top(), region.width(), region.height(), GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+    if(m_hasMipmaps)
+        glGenerateMipmap(GL_TEXTURE_2D);
+
+    // the rest of the texture is unknown here, so a fully opaque region can't make it opaque
+    if(m_opaque) {
+        for(int i = 0; i < region.width() * region.height(); ++i) {
+            if(pixels[i * 4 + 3] != 0xFF) {
+                m_opaque = false;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
 void Texture::bind()
 {
     // must reset painter texture state
@@ -34,6 +34,9 @@ public:
     ~Texture() override;
 
     void uploadPixels(const ImagePtr& image, bool buildMipmaps = false, bool compress = false);
+    void uploadSubImage(const Point& dest, const ImagePtr& image);
+    // replaces a region with tightly packed rgba pixels and refreshes the mipmaps, false when it can't be done in place
+    bool updateRegion(const Rect& region, const uint8* pixels);
     void bind();
     void copyFromScreen(const Rect& screenRect);
     virtual bool buildHardwareMipmaps();
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "textureatlas.h"
+#include "image.h"
+#include "painter.h"
+#include "texture.h"
+
+AtlasPacker::AtlasPacker(const Size& pageSize, int maxPages, int padding) :
+    m_pageSize(pageSize), m_maxPages(maxPages), m_padding(padding)
+{
+}
+
+bool AtlasPacker::allocate(const Size& size, uint32 frame, AtlasRegion& region)
+{
+    const Size paddedSize = size + Size(m_padding);
+    if(m_maxPages <= 0 || paddedSize.width() > m_pageSize.width() || paddedSize.height() > m_pageSize.height())
+        return false;
+
+    Point pos;
+    int pageId = -1;
+    for(int i = -1, s = m_pages.size(); ++i < s;) {
+        if(allocateInPage(m_pages[i], paddedSize, pos)) {
+            pageId = i;
+            break;
+        }
+    }
+
+    if(pageId == -1) {
+        if(static_cast<int>(m_pages.size()) < m_maxPages) {
+            m_pages.emplace_back();
+            pageId = m_pages.size() - 1;
+            resetPage(m_pages[pageId]);
+        } else {
+            // evict the least recently used page, pages used in this frame can't be evicted
+            uint32 oldest = frame;
+            for(int i = -1, s = m_pages.size(); ++i < s;) {
+                if(m_pages[i].lastUsed < oldest) {
+                    oldest = m_pages[i].lastUsed;
+                    pageId = i;
+                }
+            }
+
+            if(pageId == -1)
+                return false;
+
+            resetPage(m_pages[pageId]);
+            ++m_evictions;
+        }
+
+        if(!allocateInPage(m_pages[pageId], paddedSize, pos))
+            return false;
+    }
+
+    Page& page = m_pages[pageId];
+    page.lastUsed = frame;
+
+    region.page = pageId;
+    region.generation = page.generation;
+    region.rect = Rect(pos, size);
+    return true;
+}
+
+bool AtlasPacker::allocateInPage(Page& page, const Size& size, Point& pos)
+{
+    // pick the shelf that wastes less height
+    Shelf* bestShelf = nullptr;
+    for(Shelf& shelf : page.shelves) {
+        if(shelf.height < size.height() || shelf.width + size.width() > m_pageSize.width())
+            continue;
+
+        if(!bestShelf || shelf.height < bestShelf->height)
+            bestShelf = &shelf;
+    }
+
+    // avoid wasting too much space by stacking small images into tall shelves
+    if(bestShelf && bestShelf->height > size.height() * 2 && page.top + size.height() <= m_pageSize.height())
+        bestShelf = nullptr;
+
+    if(!bestShelf) {
+        if(page.top + size.height() > m_pageSize.height())
+            return false;
+
+        page.shelves.push_back({ page.top, size.height(), 0 });
+        page.top += size.height();
+        bestShelf = &page.shelves.back();
+    }
+
+    pos = Point(bestShelf->width, bestShelf->y);
+    bestShelf->width += size.width();
+    return true;
+}
+
+void AtlasPacker::resetPage(Page& page)
+{
+    page.shelves.clear();
+    page.top = 0;
+    page.generation = ++m_generation;
+}
+
+void AtlasPacker::clear()
+{
+    for(Page& page : m_pages)
+        resetPage(page);
+}
+
+void TextureAtlas::init(const Size& pageSize, int maxPages)
+{
+    terminate();
+    m_packer = AtlasPacker(pageSize, maxPages);
+}
+
+void TextureAtlas::terminate()
+{
+    m_packer.clear();
+    m_pages.clear();
+}
+
+void TextureAtlas::clear()
+{
+    m_packer.clear();
+}
+
+bool TextureAtlas::insert(const ImagePtr& image, AtlasRegion& region)
+{
+    if(!isEnabled() || image->getBpp() != 4)
+        return false;
+
+    updateFrame();
+
+    if(!m_packer.allocate(image->getSize(), m_frame, region))
+        return false;
+
+    if(region.page >= static_cast<int>(m_pages.size()))
+        m_pages.resize(region.page + 1);
+
+    TexturePtr& page = m_pages[region.page];
+    if(!page) {
+        page = TexturePtr(new Texture(m_packer.getPageSize()));
+        if(page->isEmpty()) {
+            // the page size is not supported, disable the atlas
+            g_logger.error("unable to create texture atlas page, disabling the texture atlas");
+            m_packer = AtlasPacker();
+            m_pages.clear();
+            return false;
+        }
+    }
+
+    page->uploadSubImage(region.rect.topLeft(), image);
+    return true;
+}
+
+const TexturePtr& TextureAtlas::getTexture(const AtlasRegion& region)
+{
+    updateFrame();
+    m_packer.touch(region, m_frame);
+    return m_pages[region.page];
+}
+
+void TextureAtlas::updateFrame()
+{
+    const uint32 frame = g_painter->getFrameCount();
+    if(frame == m_frame)
+        return;
+
+    // evictions only happen while inserting, so if the frame counter jumped
+    // more than once, nothing was evicted in the last frame
+    const uint32 evictions = m_packer.getEvictions();
+    m_lastFrameEvictions = frame == m_frame + 1 ? evictions - m_frameStartEvictions : 0;
+    m_frameStartEvictions = evictions;
+    m_frame = frame;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TEXTUREATLAS_H
+#define TEXTUREATLAS_H
+
+#include "declarations.h"
+
+struct AtlasRegion
+{
+    int page{ -1 };
+    uint32 generation{ 0 };
+    Rect rect;
+};
+
+// CPU side of the atlas, it only deals with rects and has no gl dependency.
+// Each page is filled with shelves, when every page is full the page that was
+// used the longest time ago is evicted as a whole and its regions become invalid.
+class AtlasPacker
+{
+public:
+    AtlasPacker(const Size& pageSize = Size(), int maxPages = 0, int padding = 1);
+
+    bool allocate(const Size& size, uint32 frame, AtlasRegion& region);
+    void touch(const AtlasRegion& region, uint32 frame) { m_pages[region.page].lastUsed = frame; }
+    void clear();
+
+    bool isValid(const AtlasRegion& region) const { return region.page >= 0 && region.page < static_cast<int>(m_pages.size()) && m_pages[region.page].generation == region.generation; }
+
+    const Size& getPageSize() const { return m_pageSize; }
+    int getPageCount() const { return m_pages.size(); }
+    int getMaxPages() const { return m_maxPages; }
+    uint32 getEvictions() const { return m_evictions; }
+
+private:
+    struct Shelf {
+        int y, height, width;
+    };
+
+    struct Page {
+        std::vector<Shelf> shelves;
+        int top{ 0 };
+        uint32 generation{ 0 };
+        uint32 lastUsed{ 0 };
+    };
+
+    bool allocateInPage(Page& page, const Size& size, Point& pos);
+    void resetPage(Page& page);
+
+    std::vector<Page> m_pages;
+    Size m_pageSize;
+    int m_maxPages;
+    int m_padding;
+    uint32 m_generation{ 0 };
+    uint32 m_evictions{ 0 };
+};
+
+class TextureAtlas
+{
+public:
+    void init(const Size& pageSize, int maxPages);
+    void terminate();
+    void clear();
+
+    bool insert(const ImagePtr& image, AtlasRegion& region);
+    bool isValid(const AtlasRegion& region) const { return m_packer.isValid(region); }
+    const TexturePtr& getTexture(const AtlasRegion& region);
+
+    bool isEnabled() const { return m_packer.getMaxPages() > 0; }
+    int getPageCount() const { return m_packer.getPageCount(); }
+    uint32 getFrameEvictions() { updateFrame(); return m_lastFrameEvictions; }
+
+private:
+    void updateFrame();
+
+    AtlasPacker m_packer;
+    std::vector<TexturePtr> m_pages;
+    uint32 m_frame{ 0 };
+    uint32 m_frameStartEvictions{ 0 };
+    uint32 m_lastFrameEvictions{ 0 };
+};
+
+#endif
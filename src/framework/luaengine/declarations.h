@@ -29,6 +29,8 @@
 
 class LuaInterface;
 class LuaObject;
+class LuaKey;
+class LuaGlobalField;
 
 using LuaCppFunction = std::function<int(LuaInterface*)>;
 using LuaCppFunctionPtr = std::unique_ptr<LuaCppFunction>;
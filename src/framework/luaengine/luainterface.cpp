@@ -668,6 +668,9 @@ void LuaInterface::createLuaState()
     if(!L)
         g_logger.fatal("Unable to create lua state");
 
+    // refs kept by LuaKey and LuaGlobalField belong to the previous state
+    ++m_stateId;
+
     // load lua standard libraries
     luaL_openlibs(L);
 
@@ -949,6 +952,45 @@ void LuaInterface::getGlobalField(const std::string & globalKey, const std::stri
     }
 }
 
+void LuaInterface::getGlobalField(const LuaGlobalField& field)
+{
+    // the global table is resolved again when the state was recreated or modules were reloaded
+    if(field.m_stateId != m_stateId || field.m_generation != m_globalFieldsGeneration) {
+        if(field.m_stateId == m_stateId)
+            unref(field.m_globalRef);
+
+        getGlobal(field.getGlobal());
+        field.m_globalRef = ref();
+        field.m_stateId = m_stateId;
+        field.m_generation = m_globalFieldsGeneration;
+    }
+
+    getRef(field.m_globalRef);
+    if(!isNil()) {
+        assert(isTable() || isUserdata());
+        getField(field.m_field);
+        remove(-2);
+    }
+}
+
+void LuaInterface::getField(const LuaKey& key, int index)
+{
+    assert(hasIndex(index));
+    assert(isUserdata(index) || isTable(index));
+    pushKey(key);
+    getTable(index < 0 ? index - 1 : index);
+}
+
+void LuaInterface::pushKey(const LuaKey& key)
+{
+    if(key.m_stateId != m_stateId) {
+        pushCString(key.m_key);
+        key.m_ref = ref();
+        key.m_stateId = m_stateId;
+    }
+    getRef(key.m_ref);
+}
+
 void LuaInterface::setGlobal(const std::string & key)
 {
     assert(hasIndex(-1));
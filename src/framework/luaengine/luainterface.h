@@ -28,6 +28,46 @@
 struct lua_State;
 using LuaCFunction = int (*)(lua_State*);
 
+/// Field name interned once as a lua string kept in the registry,
+/// pushing it again doesn't build a std::string nor hash the key.
+/// Use LUA_KEY so each call site keeps its own static key.
+class LuaKey
+{
+public:
+    explicit LuaKey(const char* key) : m_key(key) {}
+
+    const char* get() const { return m_key; }
+
+private:
+    const char* m_key;
+    mutable int m_ref{ -1 };
+    mutable uint m_stateId{ 0 };
+
+    friend class LuaInterface;
+};
+
+/// Field of a global table, the global table is resolved once and kept in the
+/// registry until the lua state is recreated or modules are reloaded
+class LuaGlobalField
+{
+public:
+    LuaGlobalField(const char* global, const char* field) : m_global(global), m_field(field) {}
+
+    const char* getGlobal() const { return m_global.get(); }
+    const char* getField() const { return m_field.get(); }
+
+private:
+    LuaKey m_global, m_field;
+    mutable int m_globalRef{ -1 };
+    mutable uint m_stateId{ 0 };
+    mutable uint m_generation{ 0 };
+
+    friend class LuaInterface;
+};
+
+#define LUA_KEY(key) ([]() -> const LuaKey& { static const LuaKey luaKey(key); return luaKey; }())
+#define LUA_GLOBAL_FIELD(global, field) ([]() -> const LuaGlobalField& { static const LuaGlobalField luaField(global, field); return luaField; }())
+
 /// Class that manages LUA stuff
 class LuaInterface
 {
@@ -194,12 +234,21 @@ public:
 
     template<typename... T>
     int luaCallGlobalField(const std::string& global, const std::string& field, const T&... args);
+    template<typename... T>
+    int luaCallGlobalField(const LuaGlobalField& field, const T&... args);
 
     template<typename... T>
     void callGlobalField(const std::string& global, const std::string& field, const T&... args);
+    template<typename... T>
+    void callGlobalField(const LuaGlobalField& field, const T&... args);
 
     template<typename R, typename... T>
     R callGlobalField(const std::string& global, const std::string& field, const T&... args);
+    template<typename R, typename... T>
+    R callGlobalField(const LuaGlobalField& field, const T&... args);
+
+    /// Drops the cached globals of LuaGlobalField, they are resolved again on their next use
+    void invalidateGlobalFields() { ++m_globalFieldsGeneration; }
 
     bool isInCppCallback() { return m_cppCallbackDepth != 0; }
 
@@ -270,6 +319,9 @@ public:
 
     void getGlobal(const std::string& key);
     void getGlobalField(const std::string& globalKey, const std::string& fieldKey);
+    void getGlobalField(const LuaGlobalField& field);
+    void getField(const LuaKey& key, int index = -1);
+    void pushKey(const LuaKey& key);
     void setGlobal(const std::string& key);
 
     void rawGet(int index = -1);
@@ -349,6 +401,8 @@ private:
     int m_totalObjRefs;
     int m_totalFuncRefs;
     int m_globalEnv;
+    uint m_stateId{ 0 };
+    uint m_globalFieldsGeneration{ 0 };
 };
 
 extern LuaInterface g_lua;
@@ -461,6 +515,18 @@ int LuaInterface::luaCallGlobalField(const std::string& global, const std::strin
     return 0;
 }
 
+template<typename... T>
+int LuaInterface::luaCallGlobalField(const LuaGlobalField& field, const T&... args)
+{
+    g_lua.getGlobalField(field);
+    if(!g_lua.isNil()) {
+        const int numArgs = g_lua.polymorphicPush(args...);
+        return g_lua.signalCall(numArgs);
+    }
+    g_lua.pop(1);
+    return 0;
+}
+
 template<typename... T>
 void LuaInterface::callGlobalField(const std::string& global, const std::string& field, const T&... args)
 {
@@ -469,6 +535,14 @@ void LuaInterface::callGlobalField(const std::string& global, const std::string&
         pop(rets);
 }
 
+template<typename... T>
+void LuaInterface::callGlobalField(const LuaGlobalField& field, const T&... args)
+{
+    const int rets = luaCallGlobalField(field, args...);
+    if(rets > 0)
+        pop(rets);
+}
+
 template<typename R, typename... T>
 R LuaInterface::callGlobalField(const std::string& global, const std::string& field, const T&... args)
 {
@@ -482,4 +556,17 @@ R LuaInterface::callGlobalField(const std::string& global, const std::string& fi
     return result;
 }
 
+template<typename R, typename... T>
+R LuaInterface::callGlobalField(const LuaGlobalField& field, const T&... args)
+{
+    R result;
+    const int rets = luaCallGlobalField(field, args...);
+    if(rets > 0) {
+        assert(rets == 1);
+        result = g_lua.polymorphicPop<R>();
+    } else
+        result = R();
+    return result;
+}
+
 #endif
@@ -41,11 +41,17 @@ public:
     /// @return the number of results
     template<typename... T>
     int luaCallLuaField(const std::string& field, const T&... args);
+    template<typename... T>
+    int luaCallLuaField(const LuaKey& field, const T&... args);
 
     template<typename R, typename... T>
     R callLuaField(const std::string& field, const T&... args);
+    template<typename R, typename... T>
+    R callLuaField(const LuaKey& field, const T&... args);
     template<typename... T>
     void callLuaField(const std::string& field, const T&... args);
+    template<typename... T>
+    void callLuaField(const LuaKey& field, const T&... args);
 
     /// Returns true if the lua field exists
     bool hasLuaField(const std::string& field);
@@ -192,6 +198,44 @@ void LuaObject::callLuaField(const std::string& field, const T&... args)
         g_lua.pop(rets);
 }
 
+template<typename... T>
+int LuaObject::luaCallLuaField(const LuaKey& field, const T&... args)
+{
+    // same as above, but the key is pushed from the registry
+    g_lua.pushObject(asLuaObject());
+    g_lua.getField(field);
+
+    if(!g_lua.isNil()) {
+        // the first argument is always this object (self)
+        g_lua.insert(-2);
+        const int numArgs = g_lua.polymorphicPush(args...);
+        return g_lua.signalCall(1 + numArgs);
+    }
+    g_lua.pop(2);
+    return 0;
+}
+
+template<typename R, typename... T>
+R LuaObject::callLuaField(const LuaKey& field, const T&... args)
+{
+    R result;
+    const int rets = luaCallLuaField(field, args...);
+    if(rets > 0) {
+        assert(rets == 1);
+        result = g_lua.polymorphicPop<R>();
+    } else
+        result = R();
+    return result;
+}
+
+template<typename... T>
+void LuaObject::callLuaField(const LuaKey& field, const T&... args)
+{
+    const int rets = luaCallLuaField(field, args...);
+    if(rets > 0)
+        g_lua.pop(rets);
+}
+
 template<typename T>
 void LuaObject::setLuaField(const std::string& key, const T& value)
 {
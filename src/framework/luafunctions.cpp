@@ -25,6 +25,7 @@
 #include <framework/core/eventdispatcher.h>
 #include <framework/core/configmanager.h>
 #include <framework/core/config.h>
+#include <framework/core/framearena.h>
 #include <framework/otml/otml.h>
 #include <framework/core/modulemanager.h>
 #include <framework/core/module.h>
@@ -132,6 +133,12 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_clock", "millis", &Clock::millis, &g_clock);
     g_lua.bindSingletonFunction("g_clock", "seconds", &Clock::seconds, &g_clock);
 
+    // FrameArena
+    g_lua.registerSingletonClass("g_frameArena");
+    g_lua.bindSingletonFunction("g_frameArena", "getFrameAllocations", &FrameArena::getFrameAllocations, &g_frameArena);
+    g_lua.bindSingletonFunction("g_frameArena", "getFrameBytes", &FrameArena::getFrameBytes, &g_frameArena);
+    g_lua.bindSingletonFunction("g_frameArena", "getBufferSize", &FrameArena::getBufferSize, &g_frameArena);
+
     // ConfigManager
     g_lua.registerSingletonClass("g_configs");
     g_lua.bindSingletonFunction("g_configs", "getSettings", &ConfigManager::getSettings, &g_configs);
@@ -169,6 +176,9 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_dispatcher", "addEvent", &EventDispatcher::addEvent, &g_dispatcher);
     g_lua.bindSingletonFunction("g_dispatcher", "scheduleEvent", &EventDispatcher::scheduleEvent, &g_dispatcher);
     g_lua.bindSingletonFunction("g_dispatcher", "cycleEvent", &EventDispatcher::cycleEvent, &g_dispatcher);
+    g_lua.bindSingletonFunction("g_dispatcher", "getPollEventCount", &EventDispatcher::getPollEventCount, &g_dispatcher);
+    g_lua.bindSingletonFunction("g_dispatcher", "getPollTime", &EventDispatcher::getPollTime, &g_dispatcher);
+    g_lua.bindSingletonFunction("g_dispatcher", "getScheduledEventCount", &EventDispatcher::getScheduledEventCount, &g_dispatcher);
 
     // ResourceManager
     g_lua.registerSingletonClass("g_resources");
@@ -314,6 +324,10 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_graphics", "setShouldUseShaders", &Graphics::setShouldUseShaders, &g_graphics);
     g_lua.bindSingletonFunction("g_graphics", "getPainterEngine", &Graphics::getPainterEngine, &g_graphics);
     g_lua.bindSingletonFunction("g_graphics", "getViewportSize", &Graphics::getViewportSize, &g_graphics);
+    g_lua.bindSingletonFunction("g_graphics", "getTextureBinds", &Graphics::getTextureBinds, &g_graphics);
+    g_lua.bindSingletonFunction("g_graphics", "getDrawCalls", &Graphics::getDrawCalls, &g_graphics);
+    g_lua.bindSingletonFunction("g_graphics", "getDrawBatches", &Graphics::getDrawBatches, &g_graphics);
+    g_lua.bindSingletonFunction("g_graphics", "getBatchedQuads", &Graphics::getBatchedQuads, &g_graphics);
     g_lua.bindSingletonFunction("g_graphics", "getVendor", &Graphics::getVendor, &g_graphics);
     g_lua.bindSingletonFunction("g_graphics", "getRenderer", &Graphics::getRenderer, &g_graphics);
     g_lua.bindSingletonFunction("g_graphics", "getVersion", &Graphics::getVersion, &g_graphics);
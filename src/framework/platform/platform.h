@@ -41,6 +41,9 @@ public:
     bool fileExists(std::string file);
     bool removeFile(std::string file);
     ticks_t getFileModificationTime(std::string file);
+    // maps a whole file read only into memory, returns nullptr on failure
+    const uint8* mapFile(std::string file, size_t& size);
+    void unmapFile(const uint8* data, size_t size);
     void openUrl(std::string url);
     std::string getCPUName();
     double getTotalSystemMemory();
@@ -29,6 +29,8 @@
 #include <framework/stdext/stdext.h>
 
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <execinfo.h>
 
 void Platform::processArgs(std::vector<std::string>& args)
@@ -102,6 +104,35 @@ bool Platform::fileExists(std::string file)
     return (stat(file.c_str(), &buffer) == 0);
 }
 
+const uint8* Platform::mapFile(std::string file, size_t& size)
+{
+    size = 0;
+    const int fd = open(file.c_str(), O_RDONLY);
+    if(fd < 0)
+        return nullptr;
+
+    struct stat buffer;
+    if(fstat(fd, &buffer) != 0 || buffer.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    void* data = mmap(nullptr, buffer.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED)
+        return nullptr;
+
+    size = buffer.st_size;
+    return static_cast<const uint8*>(data);
+}
+
+void Platform::unmapFile(const uint8* data, size_t size)
+{
+    if(data)
+        munmap(const_cast<uint8*>(data), size);
+}
+
 bool Platform::removeFile(std::string file)
 {
     if(unlink(file.c_str()) == 0)
@@ -115,6 +115,41 @@ bool Platform::fileExists(std::string file)
     return (dwAttrib != INVALID_FILE_ATTRIBUTES && !(dwAttrib & FILE_ATTRIBUTE_DIRECTORY));
 }
 
+const uint8* Platform::mapFile(std::string file, size_t& size)
+{
+    size = 0;
+    boost::replace_all(file, "/", "\\");
+    const HANDLE fileHandle = CreateFileW(stdext::utf8_to_utf16(file).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(fileHandle == INVALID_HANDLE_VALUE)
+        return nullptr;
+
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart <= 0) {
+        CloseHandle(fileHandle);
+        return nullptr;
+    }
+
+    // the view keeps the mapping alive, so both handles can be closed right away
+    const HANDLE mapping = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(fileHandle);
+    if(!mapping)
+        return nullptr;
+
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if(!data)
+        return nullptr;
+
+    size = static_cast<size_t>(fileSize.QuadPart);
+    return static_cast<const uint8*>(data);
+}
+
+void Platform::unmapFile(const uint8* data, size_t size)
+{
+    if(data)
+        UnmapViewOfFile(data);
+}
+
 bool Platform::copyFile(std::string from, std::string to)
 {
     boost::replace_all(from, "/", "\\");
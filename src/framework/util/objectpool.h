@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <framework/stdext/types.h>
+#include <mutex>
+#include <new>
+
+ /**
+  * Recycles the memory of objects of a single type that are created and destroyed in large amounts.
+  * Memory is taken from the heap in chunks and freed objects go back to a free list, chunks are
+  * never released. Classes opt in by routing their operator new/delete here, so they keep being
+  * created with new and released by the shared_object refcount as usual.
+  */
+template<typename T>
+class ObjectPool
+{
+public:
+    enum {
+        CHUNK_SIZE = 256
+    };
+
+    static void* allocate(size_t size)
+    {
+        // classes derived from T inherit its operators but don't fit the slots
+        if(size != sizeof(T))
+            return ::operator new(size);
+
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+
+        ++s.allocations;
+        if(s.freeList)
+            ++s.hits;
+        else
+            grow(s);
+
+        FreeSlot* slot = s.freeList;
+        s.freeList = slot->next;
+        ++s.used;
+        return slot;
+    }
+
+    static void deallocate(void* p, size_t size)
+    {
+        if(!p)
+            return;
+
+        if(size != sizeof(T)) {
+            ::operator delete(p);
+            return;
+        }
+
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+
+        FreeSlot* slot = static_cast<FreeSlot*>(p);
+        slot->next = s.freeList;
+        s.freeList = slot;
+        --s.used;
+    }
+
+    static uint32 getCapacity() { return state().capacity; }
+    static uint32 getUsage() { return state().used; }
+    static uint64 getAllocations() { return state().allocations; }
+
+    // share of allocations served by recycled slots
+    static float getHitRate()
+    {
+        const State& s = state();
+        return s.allocations > 0 ? static_cast<float>(s.hits) / s.allocations : 0.f;
+    }
+
+private:
+    struct FreeSlot { FreeSlot* next; };
+
+    static_assert(sizeof(T) >= sizeof(FreeSlot), "pooled objects must fit a free list link");
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "pooled objects can't be over aligned");
+
+    struct State
+    {
+        std::mutex mutex;
+        FreeSlot* freeList{ nullptr };
+        uint32 capacity{ 0 };
+        uint32 used{ 0 };
+        uint64 allocations{ 0 };
+        uint64 hits{ 0 };
+    };
+
+    // never destroyed, objects may still be released by other globals at exit
+    static State& state()
+    {
+        static State* s = new State;
+        return *s;
+    }
+
+    static void grow(State& s)
+    {
+        uint8* chunk = static_cast<uint8*>(::operator new(sizeof(T) * CHUNK_SIZE));
+        for(int i = CHUNK_SIZE; --i >= 0;) {
+            FreeSlot* slot = reinterpret_cast<FreeSlot*>(chunk + i * sizeof(T));
+            slot->next = s.freeList;
+            s.freeList = slot;
+        }
+        s.capacity += CHUNK_SIZE;
+    }
+};
+
+#endif